@@ -0,0 +1,177 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "kernel_dispatch.hpp" // KERNEL_NAMESPACE
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "csr_representation.hpp" // CsrType
+#include "third-party/graph500_generator/graph_generator.h" // packed_edge
+
+using namespace std;
+
+namespace KERNEL_NAMESPACE {
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  CSR conversion                                                                                                   *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// Populate the rows of the CSR arrays, with csr_vertices[v] the end of the row of v, copying the weights of the type
+// Weight, unless weights is nullptr
+template<typename Weight>
+static void fill_rows(uint64_t num_edges, const packed_edge* edges, const Weight* weights, bool forward, bool reverse, bool sorted_by_source, const uint64_t* __restrict csr_vertices, uint64_t* __restrict tmp_indices, uint64_t* __restrict csr_edges, Weight* __restrict csr_weights){
+    if(sorted_by_source){
+        // The edges of a source are contiguous: copy them, sequentially, at the end of its row. Only the reverse edges,
+        // at the start of the rows, are scattered
+        uint64_t run_begin = 0;
+        while(run_begin < num_edges){
+            int64_t src = get_v0_from_edge(edges + run_begin);
+            uint64_t run_end = run_begin +1;
+            while(run_end < num_edges && get_v0_from_edge(edges + run_end) == src){ run_end++; }
+            assert((run_end == num_edges || get_v0_from_edge(edges + run_end) > src) && "The edges are not sorted by source");
+
+            if(forward){
+                uint64_t src_base = csr_vertices[src] - (run_end - run_begin);
+                for(uint64_t i = run_begin; i < run_end; i++){
+                    csr_edges[src_base + (i - run_begin)] = get_v1_from_edge(edges + i);
+                    if(weights != nullptr) csr_weights[src_base + (i - run_begin)] = weights[i];
+                }
+            }
+
+            if(reverse){
+                for(uint64_t i = run_begin; i < run_end; i++){
+                    uint64_t dst = get_v1_from_edge(edges + i);
+                    uint64_t dst_base = (dst == 0) ? 0 : csr_vertices[dst -1];
+                    uint64_t& dst_displacement = tmp_indices[dst];
+                    csr_edges[dst_base + dst_displacement] = src;
+                    if(weights != nullptr) csr_weights[dst_base + dst_displacement] = weights[i];
+                    dst_displacement++;
+                }
+            }
+
+            run_begin = run_end;
+        }
+    } else {
+        for(uint64_t i = 0; i < num_edges; i++){
+            uint64_t src = get_v0_from_edge(edges +i);
+            uint64_t dst = get_v1_from_edge(edges + i);
+            Weight weight = (weights != nullptr) ? weights[i] : 0;
+
+            if(forward){
+                uint64_t src_base = (src == 0) ? 0 : csr_vertices[src -1];
+                uint64_t& src_displacement = tmp_indices[src];
+                csr_edges[src_base + src_displacement] = dst;
+                if(weights != nullptr) csr_weights[src_base + src_displacement] = weight;
+                src_displacement++;
+            }
+
+            if(reverse){
+                uint64_t dst_base = (dst == 0) ? 0 : csr_vertices[dst -1];
+                uint64_t& dst_displacement = tmp_indices[dst];
+                csr_edges[dst_base + dst_displacement] = src;
+                if(weights != nullptr) csr_weights[dst_base + dst_displacement] = weight;
+                dst_displacement++;
+            }
+        }
+    }
+}
+
+// Compiled once per kernel set, see kernel_dispatch.hpp. Invoked by the constructor of CsrRepresentation. The weights
+// are an array of the type weights_type, the same of *out_csr_weights. With weights nullptr, the graph is unweighted
+// and *out_csr_weights stays nullptr
+void convert2csr(uint64_t num_edges, packed_edge* edges, void* weights, weight_type weights_type, CsrType type, bool sorted_by_source, uint64_t* out_num_vertices, uint64_t** out_csr_vertices, uint64_t** out_csr_edges, void** out_csr_weights){
+    if(edges == nullptr) { throw std::invalid_argument("[convert2csr] edges is nullptr"); }
+    if(out_num_vertices == nullptr) { throw std::invalid_argument("[convert2csr] out_num_vertices is nullptr"); }
+    if(out_csr_vertices == nullptr) { throw std::invalid_argument("[convert2csr] out_csr_vertices is nullptr"); }
+    if(out_csr_edges == nullptr) { throw std::invalid_argument("[convert2csr] out_csr_edges is nullptr"); }
+    if(out_csr_weights == nullptr) { throw std::invalid_argument("[convert2csr] out_csr_weights is nullptr"); }
+    if(*out_csr_vertices != nullptr) { throw std::invalid_argument("[convert2csr] *out_csr_vertices expected nullptr"); }
+    if(*out_csr_edges != nullptr) { throw std::invalid_argument("[convert2csr] *out_csr_edges expected nullptr"); }
+    if(*out_csr_weights != nullptr) { throw std::invalid_argument("[convert2csr] *out_csr_weights expected nullptr"); }
+    cout << "[convert2csr] Converting to the CSR representation..." << endl;
+
+    // the edge (src, dst) is stored in the row of src (forward) and/or in the row of dst (reverse)
+    const bool forward = (type != CsrType::IN_EDGES);
+    const bool reverse = (type != CsrType::OUT_EDGES);
+    const uint64_t num_entries = (forward && reverse) ? num_edges *2 : num_edges;
+
+    // find the maximum vertex id
+    uint64_t max_vertex_id = 0;
+    for(uint64_t i = 0; i < num_edges; i++){
+        max_vertex_id = max<uint64_t>(max_vertex_id, max(get_v0_from_edge(edges +i), get_v1_from_edge(edges +i)));
+    }
+    cout << "[convert2csr] Max vertex ID: " << max_vertex_id << "\n";
+    uint64_t num_vertices = max_vertex_id +1;
+
+    // allocate the output arrays
+    auto fn_free = [](void* ptr){ free(ptr); };
+    unique_ptr<uint64_t, decltype(fn_free)> ptr_csr_vertices{ (uint64_t*) calloc(sizeof(uint64_t), num_vertices), fn_free };
+    if(ptr_csr_vertices.get() == nullptr) { cerr << "[convert2csr] Cannot allocate an array to store " << (num_vertices) << " vertices"; throw std::bad_alloc(); }
+    unique_ptr<uint64_t, decltype(fn_free)> ptr_temp_vertex_ids{ (uint64_t*) calloc(sizeof(uint64_t), num_vertices), fn_free };
+    if(ptr_temp_vertex_ids.get() == nullptr) { cerr << "[convert2csr] Cannot allocate a temporary array to store " << (num_vertices) << " vertices"; throw std::bad_alloc(); }
+    unique_ptr<uint64_t, decltype(fn_free)> ptr_csr_edges{ (uint64_t*) calloc(sizeof(uint64_t), num_entries), fn_free };
+    if(ptr_csr_edges.get() == nullptr) { cerr << "[convert2csr] Cannot allocate an array to store " << (num_entries) << " edges"; throw std::bad_alloc(); }
+    unique_ptr<void, decltype(fn_free)> ptr_csr_weights{ (weights != nullptr) ? calloc(weight_size(weights_type), num_entries) : nullptr, fn_free };
+    if(weights != nullptr && ptr_csr_weights.get() == nullptr) { cerr << "[convert2csr] Cannot allocate an array to store " << (num_entries) << " weights"; throw std::bad_alloc(); }
+    uint64_t* __restrict csr_vertices = ptr_csr_vertices.get();
+    uint64_t* __restrict tmp_indices = ptr_temp_vertex_ids.get();
+    uint64_t* __restrict csr_edges = ptr_csr_edges.get();
+    void* csr_weights = ptr_csr_weights.get();
+
+    // get the number of edges per vertex
+    for(uint64_t i = 0; i < num_edges; i++){
+        assert(get_v0_from_edge(edges + i) <= max_vertex_id && "ID out of bound");
+        if(forward) csr_vertices[get_v0_from_edge(edges +i)] ++;
+        if(reverse) csr_vertices[get_v1_from_edge(edges +i)] ++;
+    }
+
+    // prefix sum
+    for(uint64_t i =1; i < num_vertices; i++){
+        csr_vertices[i] = csr_vertices[i -1] + csr_vertices[i];
+    }
+
+    // populate the arrays edges & weights
+    switch(weights_type){
+    case WEIGHT_FLOAT:
+        fill_rows(num_edges, edges, static_cast<const float*>(weights), forward, reverse, sorted_by_source, csr_vertices, tmp_indices, csr_edges, static_cast<float*>(csr_weights));
+        break;
+    case WEIGHT_INT32:
+        fill_rows(num_edges, edges, static_cast<const int32_t*>(weights), forward, reverse, sorted_by_source, csr_vertices, tmp_indices, csr_edges, static_cast<int32_t*>(csr_weights));
+        break;
+    case WEIGHT_UINT16:
+        fill_rows(num_edges, edges, static_cast<const uint16_t*>(weights), forward, reverse, sorted_by_source, csr_vertices, tmp_indices, csr_edges, static_cast<uint16_t*>(csr_weights));
+        break;
+    case WEIGHT_UINT8:
+        fill_rows(num_edges, edges, static_cast<const uint8_t*>(weights), forward, reverse, sorted_by_source, csr_vertices, tmp_indices, csr_edges, static_cast<uint8_t*>(csr_weights));
+        break;
+    default:
+        throw std::invalid_argument("[convert2csr] invalid weight type");
+    }
+
+    // return the output to the caller
+    *out_num_vertices = num_vertices;
+    *out_csr_vertices = csr_vertices; ptr_csr_vertices.release();
+    *out_csr_edges = csr_edges; ptr_csr_edges.release();
+    *out_csr_weights = csr_weights; ptr_csr_weights.release();
+}
+
+} // namespace KERNEL_NAMESPACE
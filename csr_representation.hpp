@@ -17,27 +17,56 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <iosfwd>
 
 #include "third-party/graph500_generator/graph_generator.h" // packed_edge
+#include "third-party/graph500_generator/weight_policy.h" // weight_type
+
+/**
+ * The edges stored in the rows of a CsrRepresentation
+ */
+enum class CsrType {
+    UNDIRECTED, // undirected graph, the edge (u, v) is stored twice, in the rows of u and v
+    OUT_EDGES, // directed graph, the edge (u, v) is stored once, in the row of u
+    IN_EDGES, // directed graph, the edge (u, v) is stored once, in the row of v (CSC)
+};
 
 /**
  * A CRS (or CSR) representation of the generated graph. The graph is directed
  */
 class CsrRepresentation{
+    CsrType m_type;
+    weight_type m_weights_type;
     uint64_t m_num_vertices { 0 };
     uint64_t* m_vertices { nullptr };
     uint64_t* m_edges { nullptr };
-    float* m_weights { nullptr };
+    void* m_weights { nullptr }; // array of the type m_weights_type
 
 public:
-    // Convert the undirected generated graph into a directed CSR representation
-    CsrRepresentation(uint64_t num_edges, packed_edge* edges, float* weights);
+    // Convert the generated graph into a directed CSR representation, storing both directions of the edges of an
+    // undirected graph, or only the out-edges or the in-edges of a directed graph. With sorted_by_source, the edges must
+    // be sorted by their first vertex, as the source-ordered generator makes them, and the conversion is faster. The
+    // weights are an array of the type weights_type, or nullptr for an unweighted graph
+    CsrRepresentation(uint64_t num_edges, packed_edge* edges, void* weights, weight_type weights_type = WEIGHT_FLOAT, CsrType type = CsrType::UNDIRECTED, bool sorted_by_source = false);
 
     // Destructor
     ~CsrRepresentation();
 
-    // Store the graph to path in the METIS v5 format
-    void save_metis(const char* path, bool weights_as_int32 = false) const;
+    // Store the graph to path in the METIS v5 format. For directed graphs, a line lists the out-edges (OUT_EDGES) or
+    // the in-edges (IN_EDGES) of a vertex, and the header counts each edge once. Unweighted graphs omit the weights
+    // and the format code 001 of the header
+    void save_metis(const char* path) const;
+
+    // Store the graph to path as an edge list, a line `src dst weight' per edge, in the order of the rows: sorted by
+    // source for OUT_EDGES, by destination for IN_EDGES. An undirected graph lists each edge twice. Unweighted graphs
+    // omit the weight
+    void save_plain(const char* path) const;
+
+    // The edges stored in the rows
+    CsrType type() const;
+
+    // Whether the edges have weights
+    bool has_weights() const;
 
     // The total number of vertices in the graph
     uint64_t num_vertices() const;
@@ -51,3 +80,8 @@ public:
     // Retrieve the number of outgoing edges for the given vertex_id
     uint64_t get_vertex_count(uint64_t vertex_id) const;
 };
+
+/**
+ * Write weights[index], an array of the given type, as a number
+ */
+void write_weight(std::ostream& out, const void* weights, uint64_t index, weight_type type);
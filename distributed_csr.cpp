@@ -0,0 +1,336 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "distributed_csr.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Initialisation                                                                                                   *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// The rows of convert2csr list their entries in the order of the edges or, for the edges sorted by source, first the
+// entries of the reverse edges, then those of the forward ones. The slice of the rank r precedes the slice of r +1, so
+// the rows come out in the same order when a rank stores the entries it receives by phase, then by sender, then in
+// the order they were sent
+struct ExchangePhase {
+    bool forward; // the edge (src, dst) in the row of src
+    bool reverse; // the edge (src, dst) in the row of dst
+};
+
+// The exchanges go in rounds, of at most this many edges from all the ranks together. A rank receives at most two
+// entries per edge, below the 2^31 of the counts and displacements of MPI_Alltoallv, of type int
+constexpr uint64_t EXCHANGE_EDGES_PER_ROUND = uint64_t(1) << 28;
+
+DistributedCsr::DistributedCsr(uint64_t num_edges, const packed_edge* edges, const void* weights, weight_type weights_type, CsrType type, bool sorted_by_source, MPI_Comm comm) :
+        m_comm(comm), m_type(type), m_weights_type(weights_type), m_has_weights(weights != nullptr) {
+    if(edges == nullptr && num_edges > 0) { throw std::invalid_argument("[DistributedCsr] edges is nullptr"); }
+    MPI_Comm_rank(m_comm, &m_rank);
+    MPI_Comm_size(m_comm, &m_num_ranks);
+    cout << "[DistributedCsr] Converting to the CSR representation, among " << m_num_ranks << " ranks..." << endl;
+
+    const bool forward = (type != CsrType::IN_EDGES);
+    const bool reverse = (type != CsrType::OUT_EDGES);
+    const size_t weight_bytes = m_has_weights ? weight_size(weights_type) : 0;
+    const char* weights_bytes = static_cast<const char*>(weights);
+
+    // the vertices of the graph, from the maximum vertex id of all ranks, as in convert2csr
+    uint64_t max_vertex_id = 0;
+    for(uint64_t i = 0; i < num_edges; i++){
+        max_vertex_id = max<uint64_t>(max_vertex_id, max(get_v0_from_edge(edges +i), get_v1_from_edge(edges +i)));
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &max_vertex_id, 1, MPI_UINT64_T, MPI_MAX, m_comm);
+    cout << "[DistributedCsr] Max vertex ID: " << max_vertex_id << "\n";
+    m_num_vertices = max_vertex_id +1;
+    m_first_vertex = block_begin(m_rank);
+    m_end_vertex = block_begin(m_rank +1);
+
+    vector<ExchangePhase> phases;
+    if(!sorted_by_source){
+        phases.push_back(ExchangePhase{ forward, reverse });
+    } else {
+        if(reverse) phases.push_back(ExchangePhase{ false, true });
+        if(forward) phases.push_back(ExchangePhase{ true, false });
+    }
+
+    // the entries received, by phase and sender: the row in v0, the other vertex in v1
+    vector<vector<packed_edge>> received_entries(phases.size() * m_num_ranks);
+    vector<vector<char>> received_weights(phases.size() * m_num_ranks);
+
+    // an entry and a weight as an MPI type
+    MPI_Datatype mpi_entry, mpi_weight;
+    MPI_Type_contiguous(sizeof(packed_edge), MPI_BYTE, &mpi_entry);
+    MPI_Type_commit(&mpi_entry);
+    MPI_Type_contiguous(max<int>(weight_bytes, 1), MPI_BYTE, &mpi_weight);
+    MPI_Type_commit(&mpi_weight);
+
+    const uint64_t edges_per_round = max<uint64_t>(1, EXCHANGE_EDGES_PER_ROUND / m_num_ranks);
+    uint64_t num_rounds = (num_edges + edges_per_round -1) / edges_per_round;
+    MPI_Allreduce(MPI_IN_PLACE, &num_rounds, 1, MPI_UINT64_T, MPI_MAX, m_comm); // all ranks take part in each round
+
+    vector<int> send_counts(m_num_ranks), send_displs(m_num_ranks), send_positions(m_num_ranks);
+    vector<int> recv_counts(m_num_ranks), recv_displs(m_num_ranks);
+    vector<packed_edge> send_entries, recv_entries;
+    vector<char> send_weights, recv_weights;
+    for(uint64_t round = 0; round < num_rounds; round++){
+        const uint64_t round_begin = min(num_edges, round * edges_per_round);
+        const uint64_t round_end = min(num_edges, round_begin + edges_per_round);
+
+        for(size_t phase_id = 0; phase_id < phases.size(); phase_id++){
+            const ExchangePhase& phase = phases[phase_id];
+
+            // the entries for each rank
+            fill(send_counts.begin(), send_counts.end(), 0);
+            for(uint64_t i = round_begin; i < round_end; i++){
+                if(phase.forward) send_counts[owner(get_v0_from_edge(edges +i))]++;
+                if(phase.reverse) send_counts[owner(get_v1_from_edge(edges +i))]++;
+            }
+            int num_send_entries = 0;
+            for(int r = 0; r < m_num_ranks; r++){
+                send_displs[r] = send_positions[r] = num_send_entries;
+                num_send_entries += send_counts[r];
+            }
+            send_entries.resize(num_send_entries);
+            send_weights.resize(num_send_entries * weight_bytes);
+            auto send_entry = [&](uint64_t row, uint64_t other, uint64_t i){
+                int& position = send_positions[owner(row)];
+                write_edge(send_entries.data() + position, row, other);
+                if(m_has_weights) memcpy(send_weights.data() + position * weight_bytes, weights_bytes + i * weight_bytes, weight_bytes);
+                position++;
+            };
+            for(uint64_t i = round_begin; i < round_end; i++){
+                uint64_t src = get_v0_from_edge(edges +i);
+                uint64_t dst = get_v1_from_edge(edges +i);
+                if(phase.forward) send_entry(src, dst, i);
+                if(phase.reverse) send_entry(dst, src, i);
+            }
+
+            // exchange them
+            MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, m_comm);
+            int num_recv_entries = 0;
+            for(int r = 0; r < m_num_ranks; r++){
+                recv_displs[r] = num_recv_entries;
+                num_recv_entries += recv_counts[r];
+            }
+            recv_entries.resize(num_recv_entries);
+            recv_weights.resize(num_recv_entries * weight_bytes);
+            MPI_Alltoallv(send_entries.data(), send_counts.data(), send_displs.data(), mpi_entry, recv_entries.data(), recv_counts.data(), recv_displs.data(), mpi_entry, m_comm);
+            if(m_has_weights){
+                MPI_Alltoallv(send_weights.data(), send_counts.data(), send_displs.data(), mpi_weight, recv_weights.data(), recv_counts.data(), recv_displs.data(), mpi_weight, m_comm);
+            }
+
+            // keep them by sender
+            for(int r = 0; r < m_num_ranks; r++){
+                vector<packed_edge>& entries = received_entries[phase_id * m_num_ranks + r];
+                entries.insert(entries.end(), recv_entries.begin() + recv_displs[r], recv_entries.begin() + recv_displs[r] + recv_counts[r]);
+                vector<char>& entry_weights = received_weights[phase_id * m_num_ranks + r];
+                entry_weights.insert(entry_weights.end(), recv_weights.begin() + recv_displs[r] * weight_bytes, recv_weights.begin() + (recv_displs[r] + recv_counts[r]) * weight_bytes);
+            }
+        }
+    }
+
+    MPI_Type_free(&mpi_weight);
+    MPI_Type_free(&mpi_entry);
+
+    // get the number of edges per vertex of the block
+    const uint64_t num_local_vertices = m_end_vertex - m_first_vertex;
+    m_vertices.assign(num_local_vertices, 0);
+    for(const vector<packed_edge>& entries : received_entries){
+        for(const packed_edge& entry : entries){
+            assert((uint64_t) get_v0_from_edge(&entry) >= m_first_vertex && (uint64_t) get_v0_from_edge(&entry) < m_end_vertex && "Entry of another rank");
+            m_vertices[get_v0_from_edge(&entry) - m_first_vertex]++;
+        }
+    }
+
+    // prefix sum
+    for(uint64_t i = 1; i < num_local_vertices; i++){
+        m_vertices[i] = m_vertices[i -1] + m_vertices[i];
+    }
+    const uint64_t num_local_entries = (num_local_vertices > 0) ? m_vertices.back() : 0;
+
+    // populate the arrays edges & weights, in the order of the entries received
+    m_edges.resize(num_local_entries);
+    m_weights.resize(num_local_entries * weight_bytes);
+    vector<uint64_t> tmp_indices(num_local_vertices, 0);
+    for(size_t k = 0; k < received_entries.size(); k++){
+        const vector<packed_edge>& entries = received_entries[k];
+        for(uint64_t j = 0; j < entries.size(); j++){
+            uint64_t row = get_v0_from_edge(entries.data() + j) - m_first_vertex;
+            uint64_t position = ((row == 0) ? 0 : m_vertices[row -1]) + tmp_indices[row]++;
+            m_edges[position] = get_v1_from_edge(entries.data() + j);
+            if(m_has_weights) memcpy(m_weights.data() + position * weight_bytes, received_weights[k].data() + j * weight_bytes, weight_bytes);
+        }
+        vector<packed_edge>().swap(received_entries[k]); // release the memory as we go
+        vector<char>().swap(received_weights[k]);
+    }
+
+    m_num_edges = num_local_entries;
+    MPI_Allreduce(MPI_IN_PLACE, &m_num_edges, 1, MPI_UINT64_T, MPI_SUM, m_comm);
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Properties                                                                                                       *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+CsrType DistributedCsr::type() const {
+    return m_type;
+}
+
+bool DistributedCsr::has_weights() const {
+    return m_has_weights;
+}
+
+uint64_t DistributedCsr::num_vertices() const {
+    return m_num_vertices;
+}
+
+uint64_t DistributedCsr::num_edges() const {
+    return m_num_edges;
+}
+
+uint64_t DistributedCsr::first_vertex() const {
+    return m_first_vertex;
+}
+
+uint64_t DistributedCsr::end_vertex() const {
+    return m_end_vertex;
+}
+
+// as in get_thread_range of graph_generator.c
+uint64_t DistributedCsr::block_begin(int rank) const {
+    return (uint64_t) ((unsigned __int128) m_num_vertices * rank / m_num_ranks);
+}
+
+// the last rank r with block_begin(r) <= vertex_id
+int DistributedCsr::owner(uint64_t vertex_id) const {
+    assert(vertex_id < m_num_vertices && "Invalid vertex id");
+    return (int) (((unsigned __int128) (vertex_id +1) * m_num_ranks -1) / m_num_vertices);
+}
+
+uint64_t DistributedCsr::get_vertex_base(uint64_t vertex_id) const {
+    if(vertex_id < m_first_vertex || vertex_id >= m_end_vertex)
+        throw std::out_of_range("vertex id not in the block of the rank");
+    else if(vertex_id == m_first_vertex)
+        return 0;
+    else
+        return m_vertices[vertex_id - m_first_vertex -1];
+}
+
+uint64_t DistributedCsr::get_vertex_count(uint64_t vertex_id) const {
+    if(vertex_id < m_first_vertex || vertex_id >= m_end_vertex)
+        throw std::out_of_range("vertex id not in the block of the rank");
+    else if(vertex_id == m_first_vertex)
+        return m_vertices[0];
+    else
+        return m_vertices[vertex_id - m_first_vertex] - m_vertices[vertex_id - m_first_vertex -1];
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  METIS                                                                                                            *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+void DistributedCsr::save_metis(const char* path) const {
+    assert((m_type != CsrType::UNDIRECTED || m_num_edges % 2 == 0) && "Because the input graph is undirected");
+
+    cout << "[save_metis] Writing the rows of the vertices [" << m_first_vertex << ", " << m_end_vertex << ") to `" << path << "' ..." << endl;
+    fstream f(path, ios_base::out);
+    if(!f.good()) {
+        cerr << "Cannot open the file " << path << endl;
+        abort();
+    }
+
+    // Header, of the whole graph
+    if(m_rank == 0){
+        const uint64_t num_header_edges = (m_type == CsrType::UNDIRECTED) ? m_num_edges/2 : m_num_edges;
+        f << m_num_vertices << " " << num_header_edges;
+        if(has_weights()) f << " 001"; // 001 is a special code to signal the edges have weights associated
+        f << "\n";
+        if(!f.good()){
+            cerr << "Error writing the header: " << path << endl;
+            abort();
+        }
+    }
+
+    // Body, the rows of the block
+    for(uint64_t vertex_id = m_first_vertex; vertex_id < m_end_vertex; vertex_id++){
+        uint64_t edge_base = get_vertex_base(vertex_id);
+        for(uint64_t edge_id = 0, num_edges_per_vertex_id = get_vertex_count(vertex_id); edge_id  < num_edges_per_vertex_id; edge_id ++){
+            if(edge_id > 0) f << " "; // separate from the previous pair <dst, weight>
+            f << (m_edges[edge_base + edge_id] +1); // +1, because vertices start from 1 in METIS
+            if(has_weights()){
+                f << " ";
+                write_weight(f, m_weights.data(), edge_base + edge_id, m_weights_type);
+            }
+        }
+
+        f << "\n";
+
+        if(!f.good()){
+            cerr << "Error writing in " << path << endl;
+            abort();
+        }
+    }
+
+    f.close();
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Edge list                                                                                                        *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+void DistributedCsr::save_plain(const char* path) const {
+    cout << "[save_plain] Writing the rows of the vertices [" << m_first_vertex << ", " << m_end_vertex << ") to `" << path << "' ..." << endl;
+    fstream f(path, ios_base::out);
+    if(!f.good()) {
+        cerr << "Cannot open the file " << path << endl;
+        abort();
+    }
+
+    for(uint64_t vertex_id = m_first_vertex; vertex_id < m_end_vertex; vertex_id++){
+        uint64_t edge_base = get_vertex_base(vertex_id);
+        for(uint64_t edge_id = 0, num_edges_per_vertex_id = get_vertex_count(vertex_id); edge_id  < num_edges_per_vertex_id; edge_id ++){
+            uint64_t other = m_edges[edge_base + edge_id];
+            if(m_type == CsrType::IN_EDGES){
+                f << other << " " << vertex_id;
+            } else {
+                f << vertex_id << " " << other;
+            }
+            if(has_weights()){
+                f << " ";
+                write_weight(f, m_weights.data(), edge_base + edge_id, m_weights_type);
+            }
+            f << "\n";
+        }
+
+        if(!f.good()){
+            cerr << "Error writing in " << path << endl;
+            abort();
+        }
+    }
+
+    f.close();
+}
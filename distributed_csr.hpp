@@ -0,0 +1,88 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <mpi.h>
+#include <vector>
+
+#include "csr_representation.hpp" // CsrType
+#include "third-party/graph500_generator/graph_generator.h" // packed_edge
+#include "third-party/graph500_generator/weight_policy.h" // weight_type
+
+/**
+ * A CSR representation of the generated graph, distributed among the ranks of an MPI communicator, for krongen-mpi.
+ * The vertices are split in contiguous blocks, one per rank, and a rank stores the rows of its block. Each rank brings
+ * a slice of the edges, and sends the entries of the rows to the ranks owning them, with all-to-all exchanges. The
+ * rows are those of the CsrRepresentation of the whole edge list, the slices of the ranks one after the other.
+ */
+class DistributedCsr {
+    MPI_Comm m_comm;
+    int m_rank { 0 };
+    int m_num_ranks { 1 };
+    CsrType m_type;
+    weight_type m_weights_type;
+    bool m_has_weights;
+    uint64_t m_num_vertices { 0 }; // in the whole graph
+    uint64_t m_num_edges { 0 }; // the entries of the rows of all ranks
+    uint64_t m_first_vertex { 0 }; // the block of this rank, [m_first_vertex, m_end_vertex)
+    uint64_t m_end_vertex { 0 };
+    std::vector<uint64_t> m_vertices; // the end of the row of each vertex of the block, in m_edges
+    std::vector<uint64_t> m_edges;
+    std::vector<char> m_weights; // array of the type m_weights_type, empty for unweighted graphs
+
+    // The first vertex of the block of the given rank
+    uint64_t block_begin(int rank) const;
+
+public:
+    // Collective over comm. The edges and the weights are the slice of this rank, the slices of the ranks in order
+    // make the edge list of the graph. The other arguments are as in CsrRepresentation, and must be the same in all
+    // ranks
+    DistributedCsr(uint64_t num_edges, const packed_edge* edges, const void* weights, weight_type weights_type = WEIGHT_FLOAT, CsrType type = CsrType::UNDIRECTED, bool sorted_by_source = false, MPI_Comm comm = MPI_COMM_WORLD);
+
+    // Store the rows of this rank to path, in the METIS v5 format. Only the rank 0 writes the header, of the whole
+    // graph: the files of the ranks, concatenated in order, are the METIS file of CsrRepresentation::save_metis
+    void save_metis(const char* path) const;
+
+    // Store the rows of this rank to path as an edge list, as CsrRepresentation::save_plain
+    void save_plain(const char* path) const;
+
+    // The edges stored in the rows
+    CsrType type() const;
+
+    // Whether the edges have weights
+    bool has_weights() const;
+
+    // The total number of vertices in the graph
+    uint64_t num_vertices() const;
+
+    // The total number of edges in the rows of all ranks
+    uint64_t num_edges() const;
+
+    // The block of vertices of this rank, [first_vertex(), end_vertex())
+    uint64_t first_vertex() const;
+    uint64_t end_vertex() const;
+
+    // The rank storing the row of the given vertex
+    int owner(uint64_t vertex_id) const;
+
+    // The base in the edges array of this rank for the given vertex_id, in the block of the rank
+    uint64_t get_vertex_base(uint64_t vertex_id) const;
+
+    // Retrieve the number of outgoing edges for the given vertex_id, in the block of the rank
+    uint64_t get_vertex_count(uint64_t vertex_id) const;
+};
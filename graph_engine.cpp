@@ -0,0 +1,39 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "graph_engine.hpp"
+
+#include <cstring>
+#include <strings.h> // strcasecmp
+
+using namespace std;
+
+static const GraphEngine engines[] = {
+    { "kronecker", "stochastic Kronecker graph, as in the Graph500 specification", generate_kronecker, prepare_kronecker },
+    { "erdos-renyi", "uniform random multigraph, the m edges of the Kronecker graph drawn with replacement", generate_erdos_renyi, prepare_erdos_renyi },
+    { "chung-lu", "Chung-Lu graph, with the expected degrees of --degrees or a power law, see --degree-exponent", generate_chung_lu, prepare_chung_lu },
+};
+
+const GraphEngine* find_graph_engine(const char* name){
+    for(const GraphEngine& engine : engines){
+        if(strcasecmp(engine.name, name) == 0){ return &engine; }
+    }
+    return nullptr;
+}
+
+const GraphEngine* graph_engines(int* out_num_engines){
+    if(out_num_engines != nullptr){ *out_num_engines = sizeof(engines) / sizeof(engines[0]); }
+    return engines;
+}
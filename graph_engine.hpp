@@ -0,0 +1,80 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "kronecker.hpp" // KroneckerParameters
+
+/**
+ * An engine generating the edge list of a graph model. All the engines take the same KroneckerParameters, for the
+ * seeds, the random number generator, the size (scale, num_vertices and edgefactor), the weights and the filter,
+ * ignoring the settings of the other models, and generate any range of edges on its own, with the semantics of
+ * generate_kronecker. The edge lists then go through the same CSR conversion and output.
+ */
+struct GraphEngine {
+    const char* name; // as given to --model
+    const char* description;
+
+    // See generate_kronecker in kronecker.hpp
+    int64_t (*generate)(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+
+    // The engine prepared for the parameters, allocated with new, to generate many ranges of edges of the same graph:
+    // the same edges of generate, without deriving the state of the model again at each range. Throws
+    // invalid_argument if the parameters are not valid
+    EdgeGenerator* (*prepare)(const KroneckerParameters& params);
+};
+
+/**
+ * The engine of the model with the given name, or nullptr if there is no such model
+ */
+const GraphEngine* find_graph_engine(const char* name);
+
+/**
+ * All the engines, the first is the default one (Kronecker)
+ */
+const GraphEngine* graph_engines(int* out_num_engines);
+
+/**
+ * Non-spec control graph: a uniform random multigraph with m edges drawn with replacement, on n = num_vertices vertices
+ * (2^scale by default). Each edge picks its two endpoints uniformly at random, from the random stream of its index, as
+ * the Kronecker generators draw the edges independently: the self-loops and the duplicate edges are kept, at a rate of
+ * about 1/n each, so this is not the Erdos-Renyi model G(n, m), of m distinct edges, though close to it for m << n^2.
+ * Same size and weights of the Kronecker graph with the same parameters, but no skew in the degrees. The vertex ids are
+ * not scrambled, they are already uniform.
+ */
+int64_t generate_erdos_renyi(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+EdgeGenerator* prepare_erdos_renyi(const KroneckerParameters& params);
+
+/**
+ * Non-spec degree-targeted graph: the Chung-Lu model, with m = end_edge - start_edge edges whose endpoints are picked
+ * independently, the vertex v with probability w_v / sum(w). The expected degree of v is then 2 m w_v / sum(w), or
+ * m w_v / sum(w) out-edges and as many in-edges for the directed graphs: for the degrees of degree_sequence, the graph
+ * needs m = sum(w) / 2 edges, sum(w) for the directed graphs. The weights w are either the degree_sequence of the
+ * parameters, one per vertex, or the power law w_v = (v +1)^(-1 / (degree_exponent -1)) over num_vertices (2^scale by
+ * default) vertices. The vertex ids are the positions in the sequence, not scrambled, so the parametric ids go from the
+ * highest to the lowest degree.
+ * The endpoints are sampled with two levels of alias tables, one over blocks of 2^16 vertices and one inside each
+ * block, built in parallel, at 6 bytes per vertex. generate_chung_lu builds the tables at each call, prepare_chung_lu
+ * once for all the ranges generated from the same parameters.
+ */
+int64_t generate_chung_lu(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+EdgeGenerator* prepare_chung_lu(const KroneckerParameters& params);
+
+/**
+ * The Kronecker engine prepared for the parameters, as KroneckerGraph
+ */
+EdgeGenerator* prepare_kronecker(const KroneckerParameters& params);
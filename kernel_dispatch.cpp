@@ -0,0 +1,119 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "kernel_dispatch.hpp"
+#include "graph_engine.hpp"
+
+#include <cstdlib> // getenv
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Kernel sets                                                                                                      *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// Declare the entry points of the kernel set compiled with -DKERNEL_ISA=isa
+#define DECLARE_KERNEL_SET(isa) \
+    namespace kernels_##isa { \
+        int64_t generate_kronecker(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights); \
+        KroneckerGraph::Generator* make_kronecker_graph(const KroneckerParameters& params); \
+        int64_t generate_erdos_renyi(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights); \
+        EdgeGenerator* make_erdos_renyi_graph(const KroneckerParameters& params); \
+        int64_t generate_chung_lu(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights); \
+        EdgeGenerator* make_chung_lu_graph(const KroneckerParameters& params); \
+        void convert2csr(uint64_t num_edges, packed_edge* edges, void* weights, weight_type weights_type, CsrType type, bool sorted_by_source, uint64_t* out_num_vertices, uint64_t** out_csr_vertices, uint64_t** out_csr_edges, void** out_csr_weights); \
+    }
+#define KERNEL_SET(isa) KernelSet{ #isa, kernels_##isa::generate_kronecker, kernels_##isa::make_kronecker_graph, kernels_##isa::generate_erdos_renyi, kernels_##isa::make_erdos_renyi_graph, kernels_##isa::generate_chung_lu, kernels_##isa::make_chung_lu_graph, kernels_##isa::convert2csr }
+
+#if defined(CPU_DISPATCH)
+DECLARE_KERNEL_SET(baseline)
+DECLARE_KERNEL_SET(avx2)
+DECLARE_KERNEL_SET(avx512)
+
+// The sets this CPU can run, from the fastest to the slowest
+static int supported_kernel_sets(KernelSet* sets){
+    int num_sets = 0;
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512cd") &&
+            __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx2") &&
+            __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("fma")){
+        sets[num_sets++] = KERNEL_SET(avx512);
+    }
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("fma")){
+        sets[num_sets++] = KERNEL_SET(avx2);
+    }
+    sets[num_sets++] = KERNEL_SET(baseline);
+    return num_sets;
+}
+#else
+DECLARE_KERNEL_SET(native)
+
+static int supported_kernel_sets(KernelSet* sets){
+    sets[0] = KERNEL_SET(native);
+    return 1;
+}
+#endif
+
+static KernelSet select_kernel_set(){
+    KernelSet sets[3];
+    int num_sets = supported_kernel_sets(sets);
+
+    const char* requested = getenv("KRONGEN_KERNEL_SET");
+    if(requested != nullptr && requested[0] != '\0'){
+        for(int i = 0; i < num_sets; i++){
+            if(strcmp(requested, sets[i].name) == 0){ return sets[i]; }
+        }
+        cerr << "[kernel_set] The kernel set `" << requested << "' requested by KRONGEN_KERNEL_SET is unknown or not supported by this CPU, using `" << sets[0].name << "'" << endl;
+    }
+
+    return sets[0];
+}
+
+const KernelSet& kernel_set(){
+    static const KernelSet selected = select_kernel_set();
+    return selected;
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Entry points                                                                                                     *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+int64_t generate_kronecker(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    return kernel_set().generate_kronecker(params, start_edge, end_edge, edges, weights);
+}
+
+int64_t generate_erdos_renyi(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    return kernel_set().generate_erdos_renyi(params, start_edge, end_edge, edges, weights);
+}
+
+int64_t generate_chung_lu(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    return kernel_set().generate_chung_lu(params, start_edge, end_edge, edges, weights);
+}
+
+EdgeGenerator* prepare_kronecker(const KroneckerParameters& params){
+    return kernel_set().make_kronecker_graph(params);
+}
+
+EdgeGenerator* prepare_erdos_renyi(const KroneckerParameters& params){
+    return kernel_set().make_erdos_renyi_graph(params);
+}
+
+EdgeGenerator* prepare_chung_lu(const KroneckerParameters& params){
+    return kernel_set().make_chung_lu_graph(params);
+}
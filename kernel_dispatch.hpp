@@ -0,0 +1,70 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "csr_representation.hpp" // CsrType
+#include "kronecker.hpp"
+
+/**
+ * Kernel sets. The hot code (kronecker.cpp, csr_conversion.cpp and the Graph500 generator) is compiled once per
+ * instruction set, with -DKERNEL_ISA=<isa>, and its entry points are defined in the namespace kernels_<isa>. The
+ * program selects one set at startup, according to the features of the CPU. With ./configure --enable-dispatch,
+ * the sets are baseline (x86-64), avx2 (x86-64-v3) and avx512 (x86-64-v4), otherwise there is only one set, native,
+ * built with the flags of the configuration (-march=native with --enable-optimize).
+ */
+#define KERNEL_NAMESPACE_CONCAT_(prefix, isa) prefix##isa
+#define KERNEL_NAMESPACE_CONCAT(prefix, isa) KERNEL_NAMESPACE_CONCAT_(prefix, isa)
+#if defined(KERNEL_ISA)
+#define KERNEL_NAMESPACE KERNEL_NAMESPACE_CONCAT(kernels_, KERNEL_ISA)
+#else
+#define KERNEL_NAMESPACE kernels_native
+#endif
+
+/**
+ * The entry points of a kernel set
+ */
+struct KernelSet {
+    const char* name; // baseline, avx2, avx512 or native
+
+    // See generate_kronecker in kronecker.hpp
+    int64_t (*generate_kronecker)(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+
+    // The generator of KroneckerGraph, allocated with new, for the parameters of the graph
+    KroneckerGraph::Generator* (*make_kronecker_graph)(const KroneckerParameters& params);
+
+    // See generate_erdos_renyi in graph_engine.hpp
+    int64_t (*generate_erdos_renyi)(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+
+    // The prepared Erdos-Renyi engine, allocated with new, see prepare_erdos_renyi in graph_engine.hpp
+    EdgeGenerator* (*make_erdos_renyi_graph)(const KroneckerParameters& params);
+
+    // See generate_chung_lu in graph_engine.hpp
+    int64_t (*generate_chung_lu)(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+
+    // The prepared Chung-Lu engine, allocated with new, see prepare_chung_lu in graph_engine.hpp
+    EdgeGenerator* (*make_chung_lu_graph)(const KroneckerParameters& params);
+
+    // Convert the edge list into a CSR representation, see CsrRepresentation
+    void (*convert2csr)(uint64_t num_edges, packed_edge* edges, void* weights, weight_type weights_type, CsrType type, bool sorted_by_source, uint64_t* out_num_vertices, uint64_t** out_csr_vertices, uint64_t** out_csr_edges, void** out_csr_weights);
+};
+
+/**
+ * The kernel set for this CPU, selected at the first call. The environment variable KRONGEN_KERNEL_SET can ask for a
+ * specific set, among those the CPU supports.
+ */
+const KernelSet& kernel_set();
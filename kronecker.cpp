@@ -0,0 +1,1322 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "kronecker.hpp"
+#include "graph_engine.hpp" // generate_erdos_renyi
+#include "kernel_dispatch.hpp" // KERNEL_NAMESPACE
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring> // memcpy
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits> // integral_constant
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "third-party/graph500_generator/scramble.h"
+#include "third-party/graph500_generator/utils.h" // make_mrg_seed
+#include "random_generator.hpp"
+
+using namespace std;
+
+namespace KERNEL_NAMESPACE {
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Edge filters                                                                                                     *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// Whether the filter keeps the edges of the source, a scrambled vertex id
+static inline bool keep_source(const EdgeFilter& filter, int64_t source){
+    return source >= filter.source_begin && source < filter.source_end &&
+            (filter.num_partitions == 1 || vertex_partition(source, filter.num_partitions) == filter.partition);
+}
+
+// Whether the filter keeps the edge, with the scrambled vertex ids
+static inline bool keep_edge(const EdgeFilter& filter, int64_t source, int64_t target){
+    return (filter.self_loops || source != target) && keep_source(filter, source);
+}
+
+// Move the edges [first, first + count) kept by the filter, and their weights, to the positions from out <= first, in
+// the same order. Returns the position after the last edge kept
+static int64_t compact_edges(const EdgeFilter& filter, packed_edge* edges, void* weights, weight_type type, int64_t first, int64_t count, int64_t out){
+    const size_t size = weight_size(type);
+    for(int64_t i = first; i < first + count; i++){
+        if(keep_edge(filter, get_v0_from_edge(edges + i), get_v1_from_edge(edges + i))){
+            edges[out] = edges[i];
+            if(weights != nullptr) memcpy(weight_at(weights, out, type), weight_at(weights, i, type), size);
+            out++;
+        }
+    }
+    return out;
+}
+
+// The edges kept in a chunk of the output, compacted at the start of the chunk
+struct OutputChunk {
+    int64_t m_begin = 0; // position of the first edge
+    int64_t m_count = 0; // number of edges kept
+};
+
+// Close the gaps left by the filter: move the chunks, in order, one after the other from the start of the arrays.
+// Returns the number of edges kept
+static int64_t close_gaps(const vector<OutputChunk>& chunks, packed_edge* edges, void* weights, weight_type type){
+    int64_t out = 0;
+    for(const OutputChunk& chunk : chunks){
+        if(chunk.m_begin != out && chunk.m_count > 0){
+            memmove(edges + out, edges + chunk.m_begin, chunk.m_count * sizeof(packed_edge));
+            if(weights != nullptr) memmove(weight_at(weights, out, type), weight_at(weights, chunk.m_begin, type), chunk.m_count * weight_size(type));
+        }
+        out += chunk.m_count;
+    }
+    return out;
+}
+
+// Generate the edges [0, num_edges) of a range, as offsets from its first edge, in parallel, and compact those kept by
+// the filter. Each thread takes a contiguous chunk of blocks of block_size edges, and its kernel from
+// make_block_kernel(first), the offset of its first edge, so that the kernel can carry the state of its random stream
+// from a block to the next. The kernel generate_block(begin, end, out) writes the edges [begin, end), and their weights,
+// at the positions [out, out + end - begin), with out <= begin. The filter compacts each block while it is still in the
+// cache, and the chunks are joined at the end. Returns the number of edges kept
+template<typename BlockKernelFactory>
+static int64_t generate_blocks(int64_t num_edges, int64_t block_size, const BlockKernelFactory& make_block_kernel, packed_edge* edges, void* weights, weight_type type, const EdgeFilter& filter){
+    const int64_t num_blocks = (num_edges + block_size -1) / block_size;
+    vector<OutputChunk> chunks;
+
+    #pragma omp parallel
+    {
+#if defined(_OPENMP)
+        int64_t num_threads = omp_get_num_threads();
+        int64_t thread_id = omp_get_thread_num();
+#else
+        int64_t num_threads = 1;
+        int64_t thread_id = 0;
+#endif
+        #pragma omp single
+        chunks.resize(num_threads);
+
+        const int64_t thread_begin = min(num_blocks * thread_id / num_threads * block_size, num_edges);
+        const int64_t thread_end = min(num_blocks * (thread_id +1) / num_threads * block_size, num_edges);
+        int64_t out = thread_begin; // the position of the next edge kept
+
+        auto generate_block = make_block_kernel(thread_begin);
+        for(int64_t block_begin = thread_begin; block_begin < thread_end; block_begin += block_size){
+            const int64_t block_end = min(block_begin + block_size, thread_end);
+            generate_block(block_begin, block_end, out);
+            if(filter.active()){
+                out = compact_edges(filter, edges, weights, type, out, block_end - block_begin, out);
+            } else {
+                out = block_end;
+            }
+        }
+
+        chunks[thread_id] = OutputChunk{ thread_begin, out - thread_begin };
+    }
+
+    return close_gaps(chunks, edges, weights, type);
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Edge kernel                                                                                                      *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// The initiator of the Graph500 specification, a = 0.57, b = c = 0.19, d = 0.05, is INITIATOR_A_NUMERATOR,
+// INITIATOR_BC_NUMERATOR and INITIATOR_DENOMINATOR of graph_generator.h, shared with the Graph500 kernel
+
+/**
+ * The initiator of each level of the recursion, with the SPK noise already applied, as integer thresholds in
+ * INITIATOR_DENOMINATOR units. A random value val in [0, INITIATOR_DENOMINATOR) picks the quadrant 1 if val < m_b,
+ * 2 if val < m_bc, 0 if val < m_abc and 3 otherwise. The thresholds are computed once, rather than per level & edge
+ * as generate_4way_bernoulli does in graph_generator.c when SPK_NOISE_LEVEL is set.
+ */
+class InitiatorTable {
+public:
+    struct Level {
+        uint32_t m_b; // b
+        uint32_t m_bc; // b + c
+        uint32_t m_abc; // b + c + a
+    };
+
+private:
+    Level m_levels[64];
+
+public:
+    InitiatorTable(const KroneckerParameters& params){
+        // the probabilities in INITIATOR_DENOMINATOR units
+        uint32_t numerators[4];
+        for(int i = 0; i < 4; i++){
+            if(params.initiator[i] < 0 || params.initiator[i] > 1) { throw std::invalid_argument("[InitiatorTable] the initiator probabilities must be in [0, 1]"); }
+            numerators[i] = static_cast<uint32_t>(params.initiator[i] * INITIATOR_DENOMINATOR + 0.5);
+        }
+        if(numerators[0] + numerators[1] + numerators[2] + numerators[3] != INITIATOR_DENOMINATOR) { throw std::invalid_argument("[InitiatorTable] the initiator probabilities must sum to 1"); }
+        if(params.noise < 0 || params.noise > 1) { throw std::invalid_argument("[InitiatorTable] the noise must be in [0, 1]"); }
+        const int noise = static_cast<int>(params.noise * INITIATOR_DENOMINATOR + 0.5);
+        const int a = numerators[0], b = numerators[1], c = numerators[2];
+        const int denominator = INITIATOR_DENOMINATOR;
+
+        // Seshadhri, Pinar and Kolda, "A Hitchhiker's Guide to Choosing Parameters of Stochastic Kronecker Graphs".
+        // As in generate_4way_bernoulli, the noise for each level is chosen from the level, in [-noise, noise], and
+        // a is rescaled so that a + d keeps the same proportion
+        for(int level = 0; level < params.scale; level++){
+            int noise_factor = (noise == 0) ? 0 : 2 * noise * level / params.scale - noise;
+            int adjusted_b = b + noise_factor;
+            int adjusted_c = c + noise_factor;
+            if(adjusted_b < 0 || adjusted_c < 0 || adjusted_b + adjusted_c >= denominator) { throw std::invalid_argument("[InitiatorTable] noise too high for the initiator"); }
+            int adjusted_a = a * (denominator - b - c) / (denominator - adjusted_b - adjusted_c);
+            m_levels[level].m_b = adjusted_b;
+            m_levels[level].m_bc = adjusted_b + adjusted_c;
+            // as in graph_generator.c, the probability of d drops to zero when a + b + c exceeds the denominator
+            m_levels[level].m_abc = min(adjusted_b + adjusted_c + adjusted_a, denominator);
+        }
+    }
+
+    const Level& operator[](int level) const { return m_levels[level]; }
+
+    // The probability of the quadrant at the given level, in INITIATOR_DENOMINATOR units
+    uint32_t numerator(int level, int square) const {
+        const Level& l = m_levels[level];
+        switch(square){
+        case 0: return l.m_abc - l.m_bc;
+        case 1: return l.m_b;
+        case 2: return l.m_bc - l.m_b;
+        default: return INITIATOR_DENOMINATOR - l.m_abc;
+        }
+    }
+
+    // Whether all levels use the initiator of the Graph500 specification, with no noise
+    bool is_graph500(int scale) const {
+        for(int level = 0; level < scale; level++){
+            if(m_levels[level].m_b != INITIATOR_BC_NUMERATOR || m_levels[level].m_bc != 2 * INITIATOR_BC_NUMERATOR || m_levels[level].m_abc != INITIATOR_A_NUMERATOR + 2 * INITIATOR_BC_NUMERATOR){
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Pick one of the four quadrants: 0 = (0, 0), 1 = (0, 1), 2 = (1, 0), 3 = (1, 1)
+template<typename Rng>
+static int generate_4way_bernoulli(typename Rng::Stream& stream, const InitiatorTable::Level& initiator){
+    // Generate a pseudorandom number in the range [0, INITIATOR_DENOMINATOR) without modulo bias
+    constexpr uint32_t limit = Rng::range % INITIATOR_DENOMINATOR;
+    uint32_t val = stream.next_uint();
+    while(/* unlikely */ val < limit){ val = stream.next_uint(); }
+    val %= INITIATOR_DENOMINATOR;
+    if(val < initiator.m_b) return 1;
+    if(val < initiator.m_bc) return 2;
+    if(val < initiator.m_abc) return 0;
+    return 3;
+}
+
+// The largest scale with a specialised kernel, where the number of levels of the recursion is a compile-time
+// constant. Larger scales use the kernels instantiated with Scale = 0, taking the scale at run time
+constexpr int MAX_SPECIALISED_SCALE = 48;
+
+// Invoke fn(integral_constant<int, scale>) for the scales up to MAX_SPECIALISED_SCALE, and fn(integral_constant<int, 0>)
+// otherwise. The scale is fixed for the whole generation, so the dispatch happens once, outside the loops on the edges
+template<int Scale = MAX_SPECIALISED_SCALE, typename Function>
+static void dispatch_scale(int scale, const Function& fn){
+    if constexpr (Scale == 0){
+        fn(integral_constant<int, 0>{});
+    } else if(scale == Scale){
+        fn(integral_constant<int, Scale>{});
+    } else {
+        dispatch_scale<Scale -1>(scale, fn);
+    }
+}
+
+// Make a single edge from the random stream of the edge, as make_one_edge in graph_generator.c, but leaving the vertex
+// ids unscrambled. With Scale > 0, the recursion unrolls into straight-line code; the clip-and-flip state is a flag
+// rather than the comparison base_src == base_tgt at each level. Directed edges start off the diagonal, never flipped
+template<typename Rng, int Scale = 0>
+static void make_one_edge(typename Rng::Stream& stream, int scale, const InitiatorTable& initiator, bool directed, packed_edge* result){
+    assert(Scale == 0 || Scale == scale);
+    const int num_levels = (Scale > 0) ? Scale : scale;
+    uint64_t base_src = 0, base_tgt = 0;
+    bool diagonal = !directed; // base_src == base_tgt
+    #pragma GCC unroll 64
+    for(int level = 0; level < num_levels; level++){
+        int square = generate_4way_bernoulli<Rng>(stream, initiator[level]);
+        int flip = diagonal & (square == 2); // clip-and-flip for undirected graphs, (1, 0) => (0, 1)
+        uint64_t src_offset = (square >> 1) ^ flip;
+        uint64_t tgt_offset = (square & 1) ^ flip;
+        diagonal &= (src_offset == tgt_offset);
+        base_src = (base_src << 1) | src_offset;
+        base_tgt = (base_tgt << 1) | tgt_offset;
+    }
+    assert(directed || base_src <= base_tgt);
+    write_edge(result, base_src, base_tgt);
+}
+
+// The edge kernels produce the unscrambled vertex ids of a block of edges, then the vertices of the whole block are
+// scrambled together, with the vectorised scramble_edges, while the block is still in the cache
+constexpr int64_t SCRAMBLE_BLOCK = 256;
+
+// Draw the weight of an edge, with the next value of its stream, into weights[index]
+template<typename Rng>
+static inline void draw_weight(typename Rng::Stream& stream, const weight_policy& policy, void* weights, int64_t index){
+    uint32_t value = stream.next_uint();
+    store_weight(weights, index, &policy, value, Rng::range, Rng::to_float(value));
+}
+
+// Run make_edge(stream, edge) on the edges [start_edge, end_edge), draw their weights, unless weights is nullptr, and
+// scramble their vertices with scramble_block(edges, count), in blocks of SCRAMBLE_BLOCK edges with generate_blocks.
+// The stream of a thread only needs a random access jump at the start of its chunk. Returns the number of edges kept
+template<typename Rng, typename EdgeKernel, typename Scrambler>
+static int64_t generate_edges(const Rng& rng, const EdgeKernel& make_edge, const Scrambler& scramble_block, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights, const weight_policy& policy, const EdgeFilter& filter){
+    return generate_blocks(end_edge - start_edge, SCRAMBLE_BLOCK, [&](int64_t first){
+        typename Rng::Stream next = rng.edge(start_edge + first);
+        return [&, next](int64_t begin, int64_t end, int64_t out) mutable {
+            for(int64_t i = 0; i < end - begin; i++){
+                typename Rng::Stream stream = next;
+                make_edge(stream, edges + out + i);
+                if(weights != nullptr) draw_weight<Rng>(stream, policy, weights, out + i);
+                rng.next_edge(next);
+            }
+            scramble_block(edges + out, end - begin);
+        };
+    }, edges, weights, policy.type, filter);
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Multi-level sampler                                                                                              *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+/**
+ * Non-spec fast mode: sample up to MAX_LEVELS levels of the recursion from a single random value, rather than one
+ * value per level.
+ *
+ * For k levels there are 4^k sequences of quadrants (q_1, ..., q_k). In the per-level kernel the quadrants of the
+ * levels are independent, with P(0) = a, P(1) = b, P(2) = c, P(3) = d for the initiator of each level (the rejection
+ * step in generate_4way_bernoulli makes these probabilities exact), so P(q_1, ..., q_k) = P(q_1) * ... * P(q_k). The
+ * clip-and-flip is a function of the sequence and of whether the edge is still on the diagonal when the k levels
+ * start, so it can be applied in the table too: each group of k levels has one table for the edges on the diagonal
+ * and one for the edges off the diagonal.
+ * A table stores the cumulative probabilities of the sequences, scaled to the range of the random values of the RNG,
+ * and the bits that the sequence appends to the source & target vertices. Sampling is a binary search over the
+ * cumulative probabilities.
+ *
+ * Distribution equivalence: the sampler draws from the same distribution of the per-level recursion, up to the
+ * rounding of each cumulative probability to a multiple of 1/range (range >= 2^31 -1). This is checked, when
+ * assertions are enabled, by rebuilding the probability of each sequence from the table and comparing it to the
+ * product of the initiator probabilities, and it is checked empirically by `make check', which compares the
+ * frequencies of the quadrants of the edges generated with and without the fast mode with a chi-square test, see
+ * tests/multilevel_sampler_check.cpp.
+ * The edges are not the same of the specification, as the random values are consumed differently.
+ */
+class MultiLevelSampler {
+    static constexpr int MAX_LEVELS = 4;
+    static constexpr int MAX_ENTRIES = 1 << (2 * MAX_LEVELS); // 4^MAX_LEVELS
+    static constexpr int MAX_GROUPS = 64 / MAX_LEVELS;
+
+    struct Table {
+        uint32_t m_cumulative[MAX_ENTRIES]; // upper bound, exclusive, of the random values mapping to the sequence
+        uint16_t m_guide[MAX_ENTRIES]; // m_guide[j] = first sequence with m_cumulative > j * 2^31 / 4^k
+        uint8_t m_src[MAX_ENTRIES]; // bits to append to the source vertex
+        uint8_t m_tgt[MAX_ENTRIES]; // bits to append to the target vertex
+        bool m_diagonal[MAX_ENTRIES]; // whether the edge is still on the diagonal after the sequence
+    };
+    Table m_tables[MAX_GROUPS][2]; // [levels [group * MAX_LEVELS, group * MAX_LEVELS + MAX_LEVELS)][on the diagonal]
+
+    // Build the table for the levels [first_level, first_level + num_levels)
+    void build(Table& table, const InitiatorTable& initiator, int first_level, int num_levels, bool diagonal, uint32_t range){
+        uint64_t denominator = 1;
+        for(int level = 0; level < num_levels; level++){ denominator *= INITIATOR_DENOMINATOR; }
+
+        uint64_t cumulative = 0; // numerator of the cumulative probability
+        const int num_entries = 1 << (2 * num_levels);
+        for(int sequence = 0; sequence < num_entries; sequence++){
+            uint64_t probability = 1;
+            int src = 0, tgt = 0;
+            bool on_diagonal = diagonal;
+            for(int level = 0; level < num_levels; level++){
+                int square = (sequence >> (2 * (num_levels - level -1))) & 3; // the first level in the highest bits
+                probability *= initiator.numerator(first_level + level, square);
+                int src_offset = square / 2;
+                int tgt_offset = square % 2;
+                if(on_diagonal && src_offset > tgt_offset){ swap(src_offset, tgt_offset); } // clip-and-flip
+                on_diagonal = on_diagonal && (src_offset == tgt_offset);
+                src = (src << 1) | src_offset;
+                tgt = (tgt << 1) | tgt_offset;
+            }
+            cumulative += probability;
+            table.m_cumulative[sequence] = static_cast<uint32_t>(static_cast<unsigned __int128>(cumulative) * range / denominator);
+            table.m_src[sequence] = src;
+            table.m_tgt[sequence] = tgt;
+            table.m_diagonal[sequence] = on_diagonal;
+
+            // equivalence with the per-level recursion, up to the rounding of the two bounds
+            assert(static_cast<double>(table.m_cumulative[sequence] - (sequence == 0 ? 0 : table.m_cumulative[sequence -1])) / range - static_cast<double>(probability) / denominator < 2.0 / range);
+            assert(static_cast<double>(probability) / denominator - static_cast<double>(table.m_cumulative[sequence] - (sequence == 0 ? 0 : table.m_cumulative[sequence -1])) / range < 2.0 / range);
+        }
+        assert(cumulative == denominator && table.m_cumulative[num_entries -1] == range);
+
+        // guide table, to start the search close to the sampled sequence
+        const int shift = 31 - 2 * num_levels;
+        for(int j = 0, sequence = 0; j < num_entries; j++){
+            while(table.m_cumulative[sequence] <= (static_cast<uint32_t>(j) << shift)){ sequence++; }
+            table.m_guide[j] = sequence;
+        }
+    }
+
+public:
+    MultiLevelSampler(const InitiatorTable& initiator, int scale, uint32_t range){
+        for(int group = 0; group * MAX_LEVELS < scale; group++){
+            int num_levels = min(MAX_LEVELS, scale - group * MAX_LEVELS);
+            for(int diagonal = 0; diagonal <= 1; diagonal++){
+                build(m_tables[group][diagonal], initiator, group * MAX_LEVELS, num_levels, diagonal, range);
+            }
+        }
+    }
+
+    // Make a single edge, with unscrambled vertex ids, from the random stream of the edge, consuming
+    // ceil(scale / MAX_LEVELS) values. The scale must be the same given to the constructor. Directed edges only use the
+    // tables off the diagonal
+    template<typename Stream>
+    void make_one_edge(Stream& stream, int scale, bool directed, packed_edge* result) const {
+        uint64_t base_src = 0, base_tgt = 0;
+        bool diagonal = !directed;
+        for(int level = 0; level < scale; level += MAX_LEVELS){
+            const int num_levels = min(MAX_LEVELS, scale - level);
+            const Table& table = m_tables[level / MAX_LEVELS][diagonal];
+
+            // search the first entry with m_cumulative > value, starting from the guide table
+            const uint32_t value = stream.next_uint();
+            int sequence = table.m_guide[value >> (31 - 2 * num_levels)];
+            while(table.m_cumulative[sequence] <= value){ sequence++; }
+
+            base_src = (base_src << num_levels) | table.m_src[sequence];
+            base_tgt = (base_tgt << num_levels) | table.m_tgt[sequence];
+            diagonal = table.m_diagonal[sequence];
+        }
+        write_edge(result, base_src, base_tgt);
+    }
+};
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Generalised initiator                                                                                            *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+/**
+ * Non-spec generalised stochastic Kronecker graphs: a k x k initiator and any number of vertices N <= k^scale. Each
+ * level of the recursion picks a cell (row, column) of the initiator from a single random value, with the alias method
+ * of A. J. Walker, in the construction of M. D. Vose, and appends row and column, as digits in base k, to the source
+ * and the target. The value selects a column of the alias table, value * k^2 / range, and the remainder of the division
+ * decides between the column and its alias. The undirected edges are clipped and flipped as in the 2x2 kernel: on the
+ * diagonal, the cells below it are moved to their mirror above it.
+ * The edges with a vertex >= N are rejected and drawn again, from the next values of the stream of the same edge, so
+ * that each edge is still generated on its own.
+ */
+class AliasSampler {
+public:
+    static constexpr int MAX_ORDER = 16;
+    static constexpr int MAX_CELLS = MAX_ORDER * MAX_ORDER;
+
+private:
+    struct Table {
+        uint32_t m_threshold[MAX_CELLS]; // in units of the range of the RNG: the column is kept if the remainder < m_threshold
+        uint8_t m_alias[MAX_CELLS]; // the cell picked otherwise
+    };
+    const int m_order; // k
+    const int m_num_cells; // k^2
+    vector<Table> m_tables; // one per level, or a single one for all the levels
+
+    // Vose's construction of the alias table of the probabilities of the cells
+    void build(Table& table, const double* probabilities, uint32_t range){
+        double scaled[MAX_CELLS];
+        int small[MAX_CELLS], large[MAX_CELLS];
+        int num_small = 0, num_large = 0;
+        for(int cell = 0; cell < m_num_cells; cell++){
+            scaled[cell] = probabilities[cell] * m_num_cells;
+            if(scaled[cell] < 1){ small[num_small++] = cell; } else { large[num_large++] = cell; }
+        }
+        while(num_small > 0 && num_large > 0){
+            int less = small[--num_small];
+            int more = large[--num_large];
+            table.m_threshold[less] = static_cast<uint32_t>(scaled[less] * range + 0.5);
+            table.m_alias[less] = more;
+            scaled[more] -= 1 - scaled[less];
+            if(scaled[more] < 1){ small[num_small++] = more; } else { large[num_large++] = more; }
+        }
+        // the cells left have probability 1 up to the rounding errors
+        while(num_large > 0){ int cell = large[--num_large]; table.m_threshold[cell] = range; table.m_alias[cell] = cell; }
+        while(num_small > 0){ int cell = small[--num_small]; table.m_threshold[cell] = range; table.m_alias[cell] = cell; }
+    }
+
+public:
+    // The probabilities of the k^2 cells, in row-major order, for each of the num_tables levels. With a single table,
+    // all the levels share it
+    AliasSampler(int order, int num_tables, const double* probabilities, uint32_t range) : m_order(order), m_num_cells(order * order), m_tables(num_tables) {
+        assert(order >= 2 && order <= MAX_ORDER && num_tables >= 1);
+        for(int level = 0; level < num_tables; level++){
+            build(m_tables[level], probabilities + level * m_num_cells, range);
+        }
+    }
+
+    // Make a single edge, with unscrambled vertex ids in [0, num_vertices), from the random stream of the edge
+    template<typename Rng>
+    void make_one_edge(typename Rng::Stream& stream, int scale, bool directed, uint64_t num_vertices, packed_edge* result) const {
+        const bool shared = (m_tables.size() == 1);
+        uint64_t base_src, base_tgt;
+        do {
+            base_src = base_tgt = 0;
+            bool diagonal = !directed;
+            for(int level = 0; level < scale; level++){
+                const Table& table = m_tables[shared ? 0 : level];
+                const uint64_t value = static_cast<uint64_t>(stream.next_uint()) * m_num_cells;
+                const uint32_t column = value / Rng::range;
+                const uint32_t cell = (value % Rng::range < table.m_threshold[column]) ? column : table.m_alias[column];
+                uint32_t src_digit = cell / m_order;
+                uint32_t tgt_digit = cell % m_order;
+                if(diagonal && src_digit > tgt_digit){ swap(src_digit, tgt_digit); } // clip-and-flip
+                diagonal &= (src_digit == tgt_digit);
+                base_src = base_src * m_order + src_digit;
+                base_tgt = base_tgt * m_order + tgt_digit;
+            }
+        } while(base_src >= num_vertices || base_tgt >= num_vertices);
+        write_edge(result, base_src, base_tgt);
+    }
+};
+
+// The permutation of scramble() over [0, num_vertices), for any num_vertices >= 2: the ids are scrambled on
+// ceil(log2(num_vertices)) bits, again and again until they fall in the range (cycle walking)
+static inline int64_t scramble_below(int64_t vertex, int num_bits, uint64_t num_vertices, uint64_t val0, uint64_t val1){
+    do {
+        vertex = scramble(vertex, num_bits, val0, val1);
+    } while(static_cast<uint64_t>(vertex) >= num_vertices);
+    return vertex;
+}
+
+// The alias sampler of the generalised engine, with the k x k initiator_matrix of the parameters, or the 2x2 initiator
+// and its noise, one table per level
+static unique_ptr<AliasSampler> make_alias_sampler(const KroneckerParameters& params, const InitiatorTable& initiator, int order, uint32_t range){
+    vector<double> probabilities;
+    int num_tables = 1;
+    if(params.initiator_matrix.empty()){
+        num_tables = params.scale;
+        for(int level = 0; level < params.scale; level++){
+            for(int square = 0; square < 4; square++){
+                probabilities.push_back(static_cast<double>(initiator.numerator(level, square)) / INITIATOR_DENOMINATOR);
+            }
+        }
+    } else {
+        probabilities = params.initiator_matrix;
+    }
+    return unique_ptr<AliasSampler>{ new AliasSampler(order, num_tables, probabilities.data(), range) };
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Batched Philox kernel                                                                                            *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// Consecutive edges generated together. The stream of an edge does not depend on the other edges, so the lanes only
+// share the loops and the compiler can vectorise both the Philox rounds and the recursion.
+constexpr int PHILOX_LANES = PhiloxRng::lanes;
+
+// Generate the edges [first_edge, first_edge + PHILOX_LANES), same output of make_one_edge<PhiloxRng>, with the vertex
+// ids still unscrambled. The kernel is not specialised on the scale: each instance is a large block of vector code and
+// the gain over the partially unrolled loop is small
+static void make_edge_batch(const PhiloxRng& rng, int scale, const InitiatorTable& initiator, bool directed, int64_t first_edge, packed_edge* edges, void* weights, const weight_policy& policy){
+    using lanes_t = PhiloxRng::lanes_t;
+    constexpr uint32_t limit = PhiloxRng::range % INITIATOR_DENOMINATOR;
+    constexpr uint64_t reciprocal = ((UINT64_C(1) << 45) / INITIATOR_DENOMINATOR) +1; // val / 10000 == (val * reciprocal) >> 45 for val < 2^31
+    lanes_t values[4];
+    lanes_t src = {0}, tgt = {0};
+    lanes_t rejected = {0}; // whether the lane needed a second draw in generate_4way_bernoulli
+    lanes_t diagonal = directed ? src : ~src; // whether base_src == base_tgt so far, never for directed edges
+
+    #pragma GCC unroll 64
+    for(int level = 0; level < scale; level++){
+        if(level % 4 == 0) rng.next_uint_lanes(first_edge, level / 4, values);
+        lanes_t val = values[level % 4];
+        rejected |= (lanes_t) (val < limit);
+        val -= ((val * reciprocal) >> 45) * INITIATOR_DENOMINATOR;
+        lanes_t is1 = (lanes_t) (val < initiator[level].m_b);
+        lanes_t is2 = (lanes_t) (val < initiator[level].m_bc) & ~is1;
+        lanes_t is3 = (lanes_t) (val >= initiator[level].m_abc);
+        // clip-and-flip: on the diagonal, square 2 is turned into square 1
+        src = (src << 1) | ((is3 | (is2 & ~diagonal)) & 1);
+        tgt = (tgt << 1) | ((is3 | is1 | (is2 & diagonal)) & 1);
+        diagonal &= ~(is1 | is2);
+    }
+
+    // the weight is the value after the last level
+    if(weights != nullptr && scale % 4 == 0) rng.next_uint_lanes(first_edge, scale / 4, values);
+
+    for(int lane = 0; lane < PHILOX_LANES; lane++){
+        if(/* unlikely */ rejected[lane]){ // redo the whole edge with the scalar kernel
+            PhiloxRng::Stream stream = rng.edge(first_edge + lane);
+            make_one_edge<PhiloxRng>(stream, scale, initiator, directed, edges + lane);
+            if(weights != nullptr) draw_weight<PhiloxRng>(stream, policy, weights, lane);
+        } else {
+            write_edge(edges + lane, src[lane], tgt[lane]);
+            if(weights != nullptr){
+                uint32_t value = values[scale % 4][lane];
+                store_weight(weights, lane, &policy, value, PhiloxRng::range, PhiloxRng::to_float(value));
+            }
+        }
+    }
+}
+
+// Each block of SCRAMBLE_BLOCK edges is generated by a single thread, in batches, and then scrambled, unless
+// scramble_ids is false, with generate_blocks. The chunks of the threads are made of whole blocks, so that only the last
+// block of the range has a partial batch
+static int64_t generate_edges_batched(const PhiloxRng& rng, int scale, const InitiatorTable& initiator, bool directed, bool scramble_ids, uint64_t val0, uint64_t val1, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights, const weight_policy& policy, const EdgeFilter& filter){
+    static_assert(SCRAMBLE_BLOCK % PHILOX_LANES == 0, "Partial batches must only occur in the last block");
+    return generate_blocks(end_edge - start_edge, SCRAMBLE_BLOCK, [&](int64_t){
+        return [&](int64_t begin, int64_t end, int64_t out){
+            packed_edge* block_edges = edges + out;
+            void* block_weights = weight_at(weights, out, policy.type);
+            int64_t i = 0;
+            for( ; i + PHILOX_LANES <= end - begin; i += PHILOX_LANES){
+                make_edge_batch(rng, scale, initiator, directed, start_edge + begin + i, block_edges + i, weight_at(block_weights, i, policy.type), policy);
+            }
+
+            // remaining edges, in the last block
+            for( ; i < end - begin; i++){
+                PhiloxRng::Stream stream = rng.edge(start_edge + begin + i);
+                make_one_edge<PhiloxRng>(stream, scale, initiator, directed, block_edges + i);
+                if(weights != nullptr) draw_weight<PhiloxRng>(stream, policy, block_weights, i);
+            }
+
+            if(scramble_ids) scramble_edges(block_edges, end - begin, scale, val0, val1);
+        };
+    }, edges, weights, policy.type, filter);
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Source-ordered generator                                                                                         *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+/**
+ * Non-spec source-ordered generation. Rather than dropping the M edges one at a time into the adjacency matrix, the
+ * recursion splits the number of edges of a block of the matrix among its four quadrants, with a multinomial draw.
+ * The quadrant of an edge at a level is the pair (bit of the source, bit of the target) and, given the bit of the
+ * source, the bit of the target does not depend on the other levels, so the split happens in two stages:
+ * 1. the M edges are split among the sources, with a binomial draw per node of the binary tree of the source ids and
+ *    P(bit = 1) = c + d at the level of the node. This gives the out-degree of every vertex;
+ * 2. the out-degree of each source u is split among the targets, with P(bit = 1) = b / (a + b) at the levels where the
+ *    bit of u is 0 and d / (c + d) at the levels where it is 1.
+ * A node with a single edge goes down with one Bernoulli draw per level, as in the per-edge kernel. The sources are
+ * visited in the order of their scrambled ids, so that the edge list comes out sorted by source, ready for the CSR
+ * conversion with sequential writes. The targets of a source are not sorted: sorting the scrambled ids of each row
+ * would cost a third of the generation. The top of the tree of the sources, each subtree below it and each source
+ * have their own substream of the RNG: any range of edges is generated in parallel with the same result.
+ */
+constexpr uint32_t SOURCE_SUBSTREAMS = 1; // domain of the substreams to split the edges among the sources
+constexpr uint32_t TARGET_SUBSTREAMS = 2; // domain of the substreams to split the edges of a source among the targets
+constexpr uint32_t WEIGHT_SUBSTREAMS = 3; // domain of the substreams of the weights of a source, apart from the targets
+constexpr int SOURCE_TOP_LEVELS = 12; // levels of the tree of the sources split sequentially, before the parallel subtrees
+
+// The probability that an edge takes the branch 1 at a level of the recursion
+struct SplitProbability {
+    double m_p;
+    uint32_t m_threshold; // m_p in units of the range of the RNG: a single edge takes the branch 1 if next_uint() < m_threshold
+};
+
+// A random value in (0, 1)
+template<typename Rng>
+static double next_uniform(typename Rng::Stream& stream){
+    return (stream.next_uint() + 0.5) / Rng::range;
+}
+
+// log(k!) minus its Stirling approximation (k + 1/2) log(k + 1) - (k + 1) + log(2 pi) / 2
+static double stirling_tail(double k){
+    if(k < 10){
+        return lgamma(k + 1) - (k + 0.5) * log(k + 1) + (k + 1) - 0.5 * log(2 * M_PI);
+    } else {
+        double kp1_squared = (k + 1) * (k + 1);
+        return (1.0 / 12 - (1.0 / 360 - 1.0 / 1260 / kp1_squared) / kp1_squared) / (k + 1);
+    }
+}
+
+// A random value from the binomial distribution B(n, p). For n * min(p, 1 - p) < 10 the inversion of the cumulative
+// distribution, otherwise the transformed rejection BTRS of W. Hormann, "The generation of binomial random variates",
+// Journal of Statistical Computation and Simulation, 1993
+template<typename Rng>
+static uint64_t next_binomial(typename Rng::Stream& stream, uint64_t n, const SplitProbability& probability){
+    const double p = probability.m_p;
+    if(n == 0 || p <= 0) return 0;
+    if(p >= 1) return n;
+    const double q = min(p, 1 - p);
+    uint64_t k;
+
+    if(n <= 8){ // a few edges, one draw per edge is cheaper than the inversion
+        k = 0;
+        for(uint64_t i = 0; i < n; i++){ k += (stream.next_uint() < probability.m_threshold); }
+        return k;
+    } else if(n * q < 10){
+        const double s = q / (1 - q);
+        const double a = (n + 1) * s;
+        const double r0 = exp(n * log1p(-q)); // P(k = 0)
+        const uint64_t limit = min<uint64_t>(n, 110); // P(k > 110) is negligible, and the loop must end with rounding errors
+        do {
+            double r = r0;
+            double u = next_uniform<Rng>(stream);
+            k = 0;
+            while(u > r && k <= limit){
+                u -= r;
+                k++;
+                r *= a / k - s;
+            }
+        } while(k > limit);
+    } else {
+        const double stddev = sqrt(n * q * (1 - q));
+        const double b = 1.15 + 2.53 * stddev;
+        const double a = -0.0873 + 0.0248 * b + 0.01 * q;
+        const double c = n * q + 0.5;
+        const double v_r = 0.92 - 4.2 / b;
+        const double r = q / (1 - q);
+        const double alpha = (2.83 + 5.1 / b) * stddev;
+        const double m = floor((n + 1) * q); // the mode
+        const double nd = static_cast<double>(n);
+        while(true){
+            double u = next_uniform<Rng>(stream) - 0.5;
+            double v = next_uniform<Rng>(stream);
+            double us = 0.5 - fabs(u);
+            double kd = floor((2 * a / us + b) * u + c);
+            if(kd < 0 || kd > nd) continue;
+            if(us >= 0.07 && v <= v_r){ k = kd; break; } // squeeze
+            v = log(v * alpha / (a / (us * us) + b));
+            double bound = (m + 0.5) * log((m + 1) / (r * (nd - m + 1))) + (nd + 1) * log((nd - m + 1) / (nd - kd + 1)) +
+                    (kd + 0.5) * log(r * (nd - kd + 1) / (kd + 1)) + stirling_tail(m) + stirling_tail(nd - m) -
+                    stirling_tail(kd) - stirling_tail(nd - kd);
+            if(v <= bound){ k = kd; break; }
+        }
+    }
+
+    return (p > 0.5) ? n - k : k;
+}
+
+// Split n edges among the leaves below the node prefix at the given level, from the levels [level, num_levels), and
+// invoke leaf(id, count) for the leaves with count > 0, in the order of their ids
+template<typename Rng, typename Leaf>
+static void split_edges(typename Rng::Stream& stream, const SplitProbability* probability, int level, int num_levels, uint64_t prefix, uint64_t n, const Leaf& leaf){
+    if(n == 0){
+        return;
+    } else if(n == 1){ // a single edge, one draw per level
+        for( ; level < num_levels; level++){
+            prefix = (prefix << 1) | (stream.next_uint() < probability[level].m_threshold);
+        }
+        leaf(prefix, 1);
+    } else if(level == num_levels){
+        leaf(prefix, n);
+    } else {
+        uint64_t n1 = next_binomial<Rng>(stream, n, probability[level]);
+        split_edges<Rng>(stream, probability, level +1, num_levels, prefix << 1, n - n1, leaf);
+        split_edges<Rng>(stream, probability, level +1, num_levels, (prefix << 1) | 1, n1, leaf);
+    }
+}
+
+// The source-ordered graph. The constructor splits the edges among the sources, steps 1 and 2 below, and generate()
+// produces the targets of the rows overlapping a range of edges, step 3, so that the rows are computed once for any
+// number of ranges
+class SourceOrderedRows {
+    const int m_scale;
+    const uint64_t m_num_vertices; // 2^scale
+    const uint64_t m_num_edges; // edgefactor * 2^scale
+    const bool m_scramble_ids;
+    const uint64_t m_val0, m_val1; // as in make_scramble_values
+    SplitProbability m_target_probability[64][2]; // [level][bit of the source at the level]
+    unique_ptr<uint64_t[]> m_row_offset; // the first edge of the rows, by scrambled id of the source, and num_edges at the end
+    unique_ptr<int64_t[]> m_row_source; // the unscrambled id of the source of the rows
+
+    static SplitProbability make_probability(uint32_t numerator, uint32_t denominator, uint32_t range){
+        SplitProbability result;
+        result.m_p = (denominator == 0) ? 0 : static_cast<double>(numerator) / denominator;
+        result.m_threshold = static_cast<uint32_t>(result.m_p * range + 0.5);
+        return result;
+    }
+
+public:
+    template<typename Rng>
+    SourceOrderedRows(const Rng& rng, int scale, uint64_t edgefactor, const InitiatorTable& initiator, bool scramble_ids, uint64_t val0, uint64_t val1) :
+            m_scale(scale), m_num_vertices(UINT64_C(1) << scale), m_num_edges(edgefactor << scale), m_scramble_ids(scramble_ids), m_val0(val0), m_val1(val1),
+            m_row_offset(new uint64_t[m_num_vertices +1]()), m_row_source(new int64_t[m_num_vertices]) {
+        SplitProbability source_probability[64];
+        for(int level = 0; level < scale; level++){
+            uint32_t a = initiator.numerator(level, 0), b = initiator.numerator(level, 1), c = initiator.numerator(level, 2), d = initiator.numerator(level, 3);
+            source_probability[level] = make_probability(c + d, INITIATOR_DENOMINATOR, Rng::range);
+            m_target_probability[level][0] = make_probability(b, a + b, Rng::range);
+            m_target_probability[level][1] = make_probability(d, c + d, Rng::range);
+        }
+
+        // 1. the out-degree of the sources, stored by scrambled id
+        uint64_t* row_offset = m_row_offset.get();
+        int64_t* row_source = m_row_source.get();
+        const int top_levels = min(scale, SOURCE_TOP_LEVELS);
+        vector<uint64_t> subtree_edges(UINT64_C(1) << top_levels, 0);
+        typename Rng::Stream top_stream = rng.substream(SOURCE_SUBSTREAMS, 0);
+        split_edges<Rng>(top_stream, source_probability, 0, top_levels, 0, m_num_edges, [&](uint64_t subtree, uint64_t count){
+            subtree_edges[subtree] = count;
+        });
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(int64_t subtree = 0; subtree < static_cast<int64_t>(subtree_edges.size()); subtree++){
+            typename Rng::Stream stream = rng.substream(SOURCE_SUBSTREAMS, subtree +1);
+            split_edges<Rng>(stream, source_probability, top_levels, scale, subtree, subtree_edges[subtree], [&](uint64_t source, uint64_t count){
+                int64_t row = scramble_ids ? scramble(source, scale, val0, val1) : source;
+                row_offset[row] = count;
+                row_source[row] = source;
+            });
+        }
+
+        // 2. the first edge of each row
+        uint64_t sum = 0;
+        for(uint64_t row = 0; row < m_num_vertices; row++){
+            uint64_t count = row_offset[row];
+            row_offset[row] = sum;
+            sum += count;
+        }
+        row_offset[m_num_vertices] = sum;
+        assert(sum == m_num_edges);
+    }
+
+    // 3. the targets of the rows overlapping [start_edge, end_edge), in the order of the unscrambled target ids. Returns
+    // the number of edges kept by the filter. The rows of the sources dropped are skipped altogether, the edges kept of
+    // the other rows are compacted within the row, and the rows are joined at the end
+    template<typename Rng>
+    int64_t generate(const Rng& rng, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights, const weight_policy& policy, const EdgeFilter& filter) const {
+        if(start_edge < 0 || static_cast<uint64_t>(end_edge) > m_num_edges) { throw std::invalid_argument("[generate_kronecker] the edges must be in [0, edgefactor * 2^scale)"); }
+        if(start_edge == end_edge) return 0;
+
+        const int scale = m_scale;
+        const uint64_t* offsets = m_row_offset.get();
+        const int64_t first_row = upper_bound(offsets, offsets + m_num_vertices +1, static_cast<uint64_t>(start_edge)) - offsets -1;
+        const int64_t last_row = lower_bound(offsets, offsets + m_num_vertices +1, static_cast<uint64_t>(end_edge)) - offsets; // exclusive
+        const bool filtered = filter.active();
+        vector<OutputChunk> chunks(filtered ? last_row - first_row : 0); // the edges kept of each row
+
+        #pragma omp parallel for schedule(dynamic, 64)
+        for(int64_t row = first_row; row < last_row; row++){
+            const int64_t row_begin = offsets[row];
+            const int64_t row_end = offsets[row +1];
+            if(row_begin == row_end || (filtered && !keep_source(filter, row))) continue;
+
+            const int64_t source = m_row_source[row];
+            SplitProbability probability[64];
+            for(int level = 0; level < scale; level++){
+                probability[level] = m_target_probability[level][(source >> (scale - level -1)) & 1];
+            }
+
+            // the whole row is generated, for the same draws of any range, but only the edges in the range are stored
+            // the weights come from their own stream, so that the targets do not depend on whether they are drawn
+            typename Rng::Stream stream = rng.substream(TARGET_SUBSTREAMS, source);
+            typename Rng::Stream weight_stream = rng.substream(WEIGHT_SUBSTREAMS, source);
+            int64_t ei = row_begin;
+            const int64_t row_out = max(row_begin, start_edge) - start_edge;
+            int64_t out = row_out; // the position of the next edge kept
+            split_edges<Rng>(stream, probability, 0, scale, 0, row_end - row_begin, [&](uint64_t target, uint64_t count){
+                int64_t scrambled_target = m_scramble_ids ? scramble(target, scale, m_val0, m_val1) : target;
+                bool keep = !filtered || filter.self_loops || scrambled_target != row;
+                for(uint64_t i = 0; i < count; i++, ei++){
+                    uint32_t weight = (weights != nullptr) ? weight_stream.next_uint() : 0;
+                    if(ei >= start_edge && ei < end_edge && keep){
+                        write_edge(edges + out, row, scrambled_target);
+                        if(weights != nullptr) store_weight(weights, out, &policy, weight, Rng::range, Rng::to_float(weight));
+                        out++;
+                    }
+                }
+            });
+            if(filtered) chunks[row - first_row] = OutputChunk{ row_out, out - row_out };
+        }
+
+        return filtered ? close_gaps(chunks, edges, weights, policy.type) : end_edge - start_edge;
+    }
+};
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Dispatcher                                                                                                       *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// Whether the parameters of the weight policy are in the domain of its distribution and, for the uniform integers,
+// the range is made of integers representable in the type
+static bool is_valid(const weight_policy& policy){
+    if(policy.type < WEIGHT_FLOAT || policy.type > WEIGHT_UINT8) return false;
+    switch(policy.distribution){
+    case WEIGHT_UNIFORM: {
+        if(!(policy.min <= policy.max) || !isfinite(policy.min) || !isfinite(policy.max)) return false;
+        if(policy.type == WEIGHT_FLOAT) return true;
+        double type_min = (policy.type == WEIGHT_INT32) ? INT32_MIN : 0;
+        double type_max = (policy.type == WEIGHT_INT32) ? INT32_MAX : (policy.type == WEIGHT_UINT16) ? UINT16_MAX : UINT8_MAX;
+        return policy.min == floor(policy.min) && policy.max == floor(policy.max) && policy.min >= type_min && policy.max <= type_max;
+    }
+    case WEIGHT_EXPONENTIAL:
+        return policy.mean > 0 && isfinite(policy.mean);
+    case WEIGHT_LOG_NORMAL:
+        return policy.sigma >= 0 && isfinite(policy.sigma) && isfinite(policy.mu);
+    case WEIGHT_LEGACY_INT32:
+        return policy.type == WEIGHT_INT32;
+    default:
+        return false;
+    }
+}
+
+// The order k of the initiator, 2 for the 2x2 initiator, or 0 if initiator_matrix is not a k x k matrix of
+// probabilities summing to 1, with k in [2, AliasSampler::MAX_ORDER]
+static int initiator_order(const KroneckerParameters& params){
+    const size_t num_cells = params.initiator_matrix.size();
+    if(num_cells == 0) return 2;
+    int order = 2;
+    while(order <= AliasSampler::MAX_ORDER && static_cast<size_t>(order * order) < num_cells){ order++; }
+    if(order > AliasSampler::MAX_ORDER || static_cast<size_t>(order * order) != num_cells) return 0;
+    double sum = 0;
+    for(double probability : params.initiator_matrix){
+        if(!(probability >= 0 && probability <= 1)) return 0;
+        sum += probability;
+    }
+    return (fabs(sum - 1) <= 1e-6) ? order : 0;
+}
+
+// Edges per call of the Graph500 kernel with a filter, compacted while they are still in the cache
+constexpr int64_t FILTER_BLOCK = 8192;
+
+// The Graph500 kernel with a filter, with generate_blocks on blocks of FILTER_BLOCK edges, each generated directly at
+// the position of the next edge kept: the parallel region of the kernel is nested and runs on the calling thread.
+// Returns the number of edges kept
+static int64_t generate_graph500_filtered(const uint_fast32_t seed[5], uint64_t val0, uint64_t val1, int scale, bool directed, const weight_policy& policy, const EdgeFilter& filter, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    return generate_blocks(end_edge - start_edge, FILTER_BLOCK, [&](int64_t){
+        return [&](int64_t begin, int64_t end, int64_t out){
+            generate_kronecker_range_scrambled(seed, val0, val1, scale, directed, &policy, start_edge + begin, start_edge + end, edges + out, weight_at(weights, out, policy.type));
+        };
+    }, edges, weights, policy.type, filter);
+}
+
+#if defined(GENERATOR_USE_PACKED_EDGE_TYPE)
+constexpr int MAX_SCALE = 48; // 48 bits per vertex in the packed_edge
+#else
+constexpr int MAX_SCALE = 62;
+#endif
+
+// The checks shared by all the engines, on the scale, the weights and the filter. The messages start with the name of
+// the engine
+static void check_parameters(const char* engine, const KroneckerParameters& params){
+    auto error = [engine](const char* message){ return std::invalid_argument(string("[") + engine + "] " + message); };
+    if(params.scale <= 0 || params.scale > MAX_SCALE) { throw error("invalid scale"); }
+    if(!is_valid(params.weight)) { throw error("invalid weight policy"); }
+    if(params.filter.source_begin > params.filter.source_end) { throw error("invalid source range of the filter"); }
+    if(params.filter.num_partitions == 0 || params.filter.partition >= params.filter.num_partitions) { throw error("invalid partition of the filter"); }
+    if(params.rng != RandomGenerator::MRG && params.rng != RandomGenerator::PHILOX) { throw error("invalid random generator"); }
+}
+
+// The checks on the range of edges
+static void check_range(const char* engine, int64_t start_edge, int64_t end_edge, packed_edge* edges){
+    if(start_edge > end_edge) { throw std::invalid_argument(string("[") + engine + "] start_edge > end_edge"); }
+    if(edges == nullptr) { throw std::invalid_argument(string("[") + engine + "] edges is nullptr"); }
+}
+
+// As check_parameters, and the range of edges
+static void check_arguments(const char* engine, const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges){
+    check_parameters(engine, params);
+    check_range(engine, start_edge, end_edge, edges);
+}
+
+/**
+ * The Kronecker engine for a set of parameters: the validation, the seed, the values of the scramble, the initiator
+ * tables and the samplers are computed by the constructor, and any range or single edge is then generated from them.
+ * Each generator above is picked here, once, from the parameters and the RNG.
+ */
+class KroneckerGenerator final : public KroneckerGraph::Generator {
+    const KroneckerParameters m_params;
+    uint64_t m_num_vertices; // k^scale or params.num_vertices
+    int m_num_bits; // ceil(log2(m_num_vertices))
+    bool m_generalised; // whether the generalised engine makes the edges
+    uint_fast32_t m_seed[5]; // the seed of the MRG, as in make_mrg_seed
+    uint64_t m_val0, m_val1; // as in make_scramble_values
+    InitiatorTable m_initiator;
+    bool m_graph500; // whether the initiator is the one of the specification, for the Graph500 kernel
+    MrgRng m_mrg;
+    PhiloxRng m_philox;
+    unique_ptr<AliasSampler> m_alias; // the generalised engine
+    unique_ptr<MultiLevelSampler> m_sampler; // with params.multilevel_sampler
+    unique_ptr<SourceOrderedRows> m_rows; // with params.source_ordered
+
+    // Invoke fn(rng) with the RNG of the parameters
+    template<typename Function>
+    auto with_rng(const Function& fn) const {
+        return (m_params.rng == RandomGenerator::PHILOX) ? fn(m_philox) : fn(m_mrg);
+    }
+
+    // Scramble the vertex ids of the edges [0, count), unless params.scramble is false. For a number of vertices that
+    // is not a power of two, the ids are cycle walked into [0, num_vertices)
+    void scramble_block(packed_edge* block, int64_t count) const {
+        if(!m_params.scramble){
+            return;
+        } else if((m_num_vertices & (m_num_vertices -1)) == 0){
+            scramble_edges(block, count, m_num_bits, m_val0, m_val1);
+        } else {
+            for(int64_t i = 0; i < count; i++){
+                write_edge(block + i, scramble_below(get_v0_from_edge(block + i), m_num_bits, m_num_vertices, m_val0, m_val1), scramble_below(get_v1_from_edge(block + i), m_num_bits, m_num_vertices, m_val0, m_val1));
+            }
+        }
+    }
+
+    // Make the edge from its random stream, with the unscrambled vertex ids, as the engine of the parameters
+    template<typename Rng>
+    void make_edge(typename Rng::Stream& stream, packed_edge* edge) const {
+        if(m_alias){
+            m_alias->make_one_edge<Rng>(stream, m_params.scale, m_params.directed, m_num_vertices, edge);
+        } else if(m_sampler){
+            m_sampler->make_one_edge(stream, m_params.scale, m_params.directed, edge);
+        } else {
+            make_one_edge<Rng>(stream, m_params.scale, m_initiator, m_params.directed, edge);
+        }
+    }
+
+    template<typename Rng>
+    int64_t generate(const Rng& rng, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const {
+        const int scale = m_params.scale;
+        const bool directed = m_params.directed;
+        const weight_policy& policy = m_params.weight;
+        const EdgeFilter& filter = m_params.filter;
+        auto scramble_block = [this](packed_edge* block, int64_t count){ this->scramble_block(block, count); };
+
+        if(m_rows){
+            return m_rows->generate(rng, start_edge, end_edge, edges, weights, policy, filter);
+        } else if(m_alias || m_sampler){
+            return generate_edges(rng, [this](typename Rng::Stream& stream, packed_edge* edge){
+                make_edge<Rng>(stream, edge);
+            }, scramble_block, start_edge, end_edge, edges, weights, policy, filter);
+        } else if constexpr (is_same<Rng, PhiloxRng>::value){
+            return generate_edges_batched(rng, scale, m_initiator, directed, m_params.scramble, m_val0, m_val1, start_edge, end_edge, edges, weights, policy, filter);
+        } else if(m_graph500 && m_params.scramble){ // the Graph500 kernel, with the initiator fixed at compile time, batched & vectorised
+            if(filter.active()){
+                return generate_graph500_filtered(m_seed, m_val0, m_val1, scale, directed, policy, filter, start_edge, end_edge, edges, weights);
+            }
+            generate_kronecker_range_scrambled(m_seed, m_val0, m_val1, scale, directed, &policy, start_edge, end_edge, edges, weights);
+            return end_edge - start_edge;
+        } else { // any other initiator, or the ids left unscrambled: for the Graph500 initiator, same edges of its kernel
+            int64_t num_kept = 0;
+            dispatch_scale(scale, [&](auto Scale){
+                num_kept = generate_edges(rng, [&](typename Rng::Stream& stream, packed_edge* edge){
+                    make_one_edge<Rng, decltype(Scale)::value>(stream, scale, m_initiator, directed, edge);
+                }, scramble_block, start_edge, end_edge, edges, weights, policy, filter);
+            });
+            return num_kept;
+        }
+    }
+
+public:
+    // The parameters must have passed check_parameters. The errors start with the name of the caller
+    KroneckerGenerator(const char* caller, const KroneckerParameters& params) : m_params(params), m_initiator(params), m_mrg(params.userseed1, params.userseed2), m_philox(params.userseed1, params.userseed2) {
+        auto error = [caller](const char* message){ return std::invalid_argument(string("[") + caller + "] " + message); };
+        const int order = initiator_order(params);
+        if(order == 0) { throw error("the initiator matrix must be k x k, with k in [2, 16], and its probabilities must sum to 1"); }
+        if(!params.initiator_matrix.empty() && params.noise != 0) { throw error("the noise only applies to the 2x2 initiator"); }
+        uint64_t max_vertices = 1; // k^scale
+        for(int level = 0; level < params.scale; level++){
+            if(max_vertices > (UINT64_C(1) << MAX_SCALE) / order) { throw error("the k^scale vertices do not fit in the vertex ids"); }
+            max_vertices *= order;
+        }
+        m_num_vertices = (params.num_vertices == 0) ? max_vertices : params.num_vertices;
+        if(m_num_vertices < 2 || m_num_vertices > max_vertices) { throw error("the number of vertices must be in [2, k^scale]"); }
+        m_num_bits = 64 - __builtin_clzll(m_num_vertices -1);
+        m_generalised = !params.initiator_matrix.empty() || m_num_vertices != max_vertices;
+        if(m_generalised && (params.source_ordered || params.multilevel_sampler)) { throw error("the k x k initiator and the exact number of vertices do not support the source-ordered generator nor the multilevel sampler"); }
+        if(m_num_vertices < max_vertices && (params.initiator_matrix.empty() ? params.initiator[0] : params.initiator_matrix[0]) <= 0) { throw error("the rejection of the vertices >= num_vertices needs a probability > 0 for the cell (0, 0) of the initiator"); }
+        if(params.source_ordered && params.multilevel_sampler) { throw error("the source-ordered generator does not use the multilevel sampler"); }
+        if(params.source_ordered && (params.edgefactor == 0 || params.edgefactor > (static_cast<uint64_t>(INT64_MAX) >> params.scale))) { throw error("invalid edge factor"); }
+
+        make_mrg_seed(params.userseed1, params.userseed2, m_seed);
+        make_scramble_values(m_seed, &m_val0, &m_val1);
+        m_graph500 = m_initiator.is_graph500(params.scale);
+
+        with_rng([&](const auto& rng){
+            using Rng = typename std::decay<decltype(rng)>::type;
+            if(m_generalised){
+                m_alias = make_alias_sampler(params, m_initiator, order, Rng::range);
+            } else if(params.source_ordered){
+                m_rows.reset(new SourceOrderedRows(rng, params.scale, params.edgefactor, m_initiator, params.scramble, m_val0, m_val1));
+            } else if(params.multilevel_sampler){
+                m_sampler.reset(new MultiLevelSampler(m_initiator, params.scale, Rng::range));
+            }
+            return 0;
+        });
+    }
+
+    uint64_t num_vertices() const override { return m_num_vertices; }
+
+    int64_t edges(int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const override {
+        check_range("generate_kronecker", start_edge, end_edge, edges);
+        return with_rng([&](const auto& rng){ return generate(rng, start_edge, end_edge, edges, weights); });
+    }
+
+    // The scalar path of the engine: the edge is the same of the batched and Graph500 kernels
+    void edge(int64_t index, packed_edge* edge, void* weight) const override {
+        if(m_rows){
+            with_rng([&](const auto& rng){ return m_rows->generate(rng, index, index +1, edge, weight, m_params.weight, EdgeFilter{}); });
+            return;
+        }
+        with_rng([&](const auto& rng){
+            using Rng = typename std::decay<decltype(rng)>::type;
+            typename Rng::Stream stream = rng.edge(index);
+            make_edge<Rng>(stream, edge);
+            if(weight != nullptr) draw_weight<Rng>(stream, m_params.weight, weight, 0);
+            scramble_block(edge, 1);
+            return 0;
+        });
+    }
+};
+
+int64_t generate_kronecker(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    check_arguments("generate_kronecker", params, start_edge, end_edge, edges);
+    return KroneckerGenerator{"generate_kronecker", params}.edges(start_edge, end_edge, edges, weights);
+}
+
+KroneckerGraph::Generator* make_kronecker_graph(const KroneckerParameters& params){
+    check_parameters("KroneckerGraph", params);
+    return new KroneckerGenerator("KroneckerGraph", params);
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Uniform random multigraph engine (erdos-renyi)                                                                   *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+// A random fraction in [0, 1), in units of 2^-62, from two values of the stream. The MRG values miss 2^31 -1, a bias
+// of at most 2^-30
+template<typename Rng>
+static inline uint64_t next_fraction(typename Rng::Stream& stream){
+    const uint64_t high = stream.next_uint();
+    const uint64_t low = stream.next_uint();
+    return (high << 31) | low;
+}
+
+// A random vertex in [0, num_vertices), the fraction multiplied by num_vertices. The bias is at most
+// num_vertices / 2^62 per vertex, plus the one of next_fraction
+template<typename Rng>
+static inline uint64_t next_vertex(typename Rng::Stream& stream, uint64_t num_vertices){
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(next_fraction<Rng>(stream)) * num_vertices) >> 62);
+}
+
+/**
+ * The engine of the uniform random multigraph (--model erdos-renyi) for a set of parameters: its state is only the RNG
+ * and the number of vertices
+ */
+class ErdosRenyiGenerator final : public EdgeGenerator {
+    const KroneckerParameters m_params;
+    uint64_t m_num_vertices;
+    MrgRng m_mrg;
+    PhiloxRng m_philox;
+
+    template<typename Rng>
+    int64_t generate(const Rng& rng, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const {
+        const uint64_t num_vertices = m_num_vertices;
+        return generate_edges(rng, [num_vertices](typename Rng::Stream& stream, packed_edge* edge){
+            uint64_t src = next_vertex<Rng>(stream, num_vertices);
+            uint64_t tgt = next_vertex<Rng>(stream, num_vertices);
+            write_edge(edge, src, tgt);
+        }, [](packed_edge* /* block */, int64_t /* count */){ } /* the ids are already uniform */, start_edge, end_edge, edges, weights, m_params.weight, m_params.filter);
+    }
+
+public:
+    // The parameters must have passed check_parameters
+    ErdosRenyiGenerator(const KroneckerParameters& params) : m_params(params), m_mrg(params.userseed1, params.userseed2), m_philox(params.userseed1, params.userseed2) {
+        m_num_vertices = (params.num_vertices == 0) ? (UINT64_C(1) << params.scale) : params.num_vertices;
+        if(m_num_vertices < 2 || m_num_vertices > (UINT64_C(1) << MAX_SCALE)) { throw std::invalid_argument("[generate_erdos_renyi] the number of vertices must be at least 2 and fit in the vertex ids"); }
+    }
+
+    uint64_t num_vertices() const override { return m_num_vertices; }
+
+    int64_t edges(int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const override {
+        check_range("generate_erdos_renyi", start_edge, end_edge, edges);
+        return (m_params.rng == RandomGenerator::PHILOX) ? generate(m_philox, start_edge, end_edge, edges, weights) : generate(m_mrg, start_edge, end_edge, edges, weights);
+    }
+};
+
+int64_t generate_erdos_renyi(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    check_arguments("generate_erdos_renyi", params, start_edge, end_edge, edges);
+    return ErdosRenyiGenerator{params}.edges(start_edge, end_edge, edges, weights);
+}
+
+EdgeGenerator* make_erdos_renyi_graph(const KroneckerParameters& params){
+    check_parameters("generate_erdos_renyi", params);
+    return new ErdosRenyiGenerator(params);
+}
+
+/*********************************************************************************************************************
+ *                                                                                                                   *
+ *  Chung-Lu engine                                                                                                  *
+ *                                                                                                                   *
+ *********************************************************************************************************************/
+/**
+ * The distribution w_v / sum(w) over the vertices, as two levels of alias tables: one over the blocks of BLOCK_SIZE
+ * vertices, with the probability of each block, and one inside each block. The tables of the blocks are independent
+ * and built in parallel, with Vose's construction, and the aliases inside a block take 16 bits. Each level takes a
+ * 62-bit fraction: the column is the integer part of fraction * entries, and the next 32 bits decide between the
+ * column and its alias, so that the probabilities are exact up to 2^-32 per entry.
+ */
+class DegreeSampler {
+    static constexpr int BLOCK_BITS = 16;
+    static constexpr uint64_t BLOCK_SIZE = UINT64_C(1) << BLOCK_BITS;
+
+    uint64_t m_num_vertices;
+    uint64_t m_num_blocks;
+    unique_ptr<uint32_t[]> m_threshold; // the column is kept if the 32 bits after the column < m_threshold
+    unique_ptr<uint16_t[]> m_alias; // the alias inside the block
+    vector<uint32_t> m_block_threshold;
+    vector<uint32_t> m_block_alias;
+
+    // Vose's construction over weights[0, n), for a total > 0. The cells left at the end hold the whole probability,
+    // up to rounding: they are their own alias
+    template<typename Alias>
+    static void build(const double* weights, uint64_t n, double total, uint32_t* threshold, Alias* alias, vector<double>& scaled, vector<uint64_t>& small, vector<uint64_t>& large){
+        scaled.resize(n);
+        small.clear();
+        large.clear();
+        for(uint64_t i = 0; i < n; i++){
+            scaled[i] = weights[i] * n / total;
+            if(scaled[i] < 1){ small.push_back(i); } else { large.push_back(i); }
+        }
+        while(!small.empty() && !large.empty()){
+            uint64_t less = small.back(); small.pop_back();
+            uint64_t more = large.back(); large.pop_back();
+            threshold[less] = static_cast<uint32_t>(min(scaled[less] * 4294967296.0 /* 2^32 */ + 0.5, 4294967295.0));
+            alias[less] = more;
+            scaled[more] -= 1 - scaled[less];
+            if(scaled[more] < 1){ small.push_back(more); } else { large.push_back(more); }
+        }
+        for(uint64_t cell : small){ threshold[cell] = UINT32_MAX; alias[cell] = cell; }
+        for(uint64_t cell : large){ threshold[cell] = UINT32_MAX; alias[cell] = cell; }
+    }
+
+    // Pick an entry of a table of num_entries entries
+    template<typename Alias>
+    static uint64_t pick(uint64_t fraction, uint64_t num_entries, const uint32_t* threshold, const Alias* alias){
+        const unsigned __int128 product = static_cast<unsigned __int128>(fraction) * num_entries;
+        const uint64_t column = static_cast<uint64_t>(product >> 62);
+        const uint32_t coin = static_cast<uint32_t>(product >> 30);
+        return (coin < threshold[column]) ? column : alias[column];
+    }
+
+public:
+    // The weights of the vertices [0, num_vertices) are weight(v), finite and >= 0, with a total > 0. Otherwise the
+    // constructor throws invalid_argument
+    template<typename Weight>
+    DegreeSampler(uint64_t num_vertices, const Weight& weight) : m_num_vertices(num_vertices), m_num_blocks((num_vertices + BLOCK_SIZE -1) / BLOCK_SIZE),
+            m_threshold(new uint32_t[num_vertices]), m_alias(new uint16_t[num_vertices]), m_block_threshold(m_num_blocks), m_block_alias(m_num_blocks) {
+        vector<double> block_weight(m_num_blocks, 0);
+        bool valid = true;
+
+        #pragma omp parallel reduction(&&: valid)
+        {
+            vector<double> weights(BLOCK_SIZE), scaled;
+            vector<uint64_t> small, large;
+            #pragma omp for schedule(dynamic, 1)
+            for(int64_t block = 0; block < static_cast<int64_t>(m_num_blocks); block++){
+                const uint64_t first = block * BLOCK_SIZE;
+                const uint64_t n = min(BLOCK_SIZE, num_vertices - first);
+                double total = 0;
+                for(uint64_t i = 0; i < n; i++){
+                    weights[i] = weight(first + i);
+                    valid = valid && weights[i] >= 0 && isfinite(weights[i]);
+                    total += weights[i];
+                }
+                block_weight[block] = total;
+                if(total > 0){
+                    build(weights.data(), n, total, m_threshold.get() + first, m_alias.get() + first, scaled, small, large);
+                } else { // never picked
+                    for(uint64_t i = 0; i < n; i++){ m_threshold[first + i] = UINT32_MAX; m_alias[first + i] = i; }
+                }
+            }
+        }
+
+        double total = 0;
+        for(double w : block_weight){ total += w; }
+        if(!valid || !(total > 0) || !isfinite(total)) { throw std::invalid_argument("[DegreeSampler] the expected degrees must be finite and >= 0, with a sum > 0"); }
+        vector<double> scaled;
+        vector<uint64_t> small, large;
+        build(block_weight.data(), m_num_blocks, total, m_block_threshold.data(), m_block_alias.data(), scaled, small, large);
+    }
+
+    uint64_t num_vertices() const { return m_num_vertices; }
+
+    // A random vertex, from four values of the stream
+    template<typename Rng>
+    uint64_t next_vertex(typename Rng::Stream& stream) const {
+        const uint64_t block = pick(next_fraction<Rng>(stream), m_num_blocks, m_block_threshold.data(), m_block_alias.data());
+        const uint64_t first = block * BLOCK_SIZE;
+        const uint64_t n = min(BLOCK_SIZE, m_num_vertices - first);
+        return first + pick(next_fraction<Rng>(stream), n, m_threshold.get() + first, m_alias.get() + first);
+    }
+};
+
+/**
+ * The Chung-Lu engine for a set of parameters: the DegreeSampler is built once, in O(num_vertices) time and memory,
+ * and any range of edges is then sampled from it
+ */
+class ChungLuGenerator final : public EdgeGenerator {
+    const KroneckerParameters m_params; // its degree_sequence is only read by the constructor
+    unique_ptr<DegreeSampler> m_sampler;
+    MrgRng m_mrg;
+    PhiloxRng m_philox;
+
+    template<typename Rng>
+    int64_t generate(const Rng& rng, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const {
+        const DegreeSampler& sampler = *m_sampler;
+        return generate_edges(rng, [&sampler](typename Rng::Stream& stream, packed_edge* edge){
+            uint64_t src = sampler.next_vertex<Rng>(stream);
+            uint64_t tgt = sampler.next_vertex<Rng>(stream);
+            write_edge(edge, src, tgt);
+        }, [](packed_edge* /* block */, int64_t /* count */){ }, start_edge, end_edge, edges, weights, m_params.weight, m_params.filter);
+    }
+
+public:
+    // The parameters must have passed check_parameters
+    ChungLuGenerator(const KroneckerParameters& params) : m_params(params), m_mrg(params.userseed1, params.userseed2), m_philox(params.userseed1, params.userseed2) {
+        const vector<double>* sequence = params.degree_sequence;
+        const uint64_t num_vertices = (sequence != nullptr) ? sequence->size() : (params.num_vertices == 0) ? (UINT64_C(1) << params.scale) : params.num_vertices;
+        if(num_vertices < 2 || num_vertices > (UINT64_C(1) << MAX_SCALE)) { throw std::invalid_argument("[generate_chung_lu] the number of vertices must be at least 2 and fit in the vertex ids"); }
+        if(sequence == nullptr && !(params.degree_exponent > 1 && isfinite(params.degree_exponent))) { throw std::invalid_argument("[generate_chung_lu] the degree exponent must be > 1"); }
+
+        const double exponent = -1 / (params.degree_exponent -1);
+        if(sequence != nullptr){
+            m_sampler.reset(new DegreeSampler{ num_vertices, [sequence](uint64_t vertex){ return (*sequence)[vertex]; } });
+        } else {
+            m_sampler.reset(new DegreeSampler{ num_vertices, [exponent](uint64_t vertex){ return pow(static_cast<double>(vertex +1), exponent); } });
+        }
+    }
+
+    uint64_t num_vertices() const override { return m_sampler->num_vertices(); }
+
+    int64_t edges(int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const override {
+        check_range("generate_chung_lu", start_edge, end_edge, edges);
+        return (m_params.rng == RandomGenerator::PHILOX) ? generate(m_philox, start_edge, end_edge, edges, weights) : generate(m_mrg, start_edge, end_edge, edges, weights);
+    }
+};
+
+int64_t generate_chung_lu(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights){
+    check_arguments("generate_chung_lu", params, start_edge, end_edge, edges);
+    return ChungLuGenerator{params}.edges(start_edge, end_edge, edges, weights);
+}
+
+EdgeGenerator* make_chung_lu_graph(const KroneckerParameters& params){
+    check_parameters("generate_chung_lu", params);
+    return new ChungLuGenerator(params);
+}
+
+} // namespace KERNEL_NAMESPACE
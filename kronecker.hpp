@@ -0,0 +1,300 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "third-party/graph500_generator/graph_generator.h" // packed_edge
+#include "third-party/graph500_generator/weight_policy.h"
+
+/**
+ * The random number generator used to create the edges
+ */
+enum class RandomGenerator {
+    MRG, // splittable MRG, as in the Graph500 specification
+    PHILOX, // counter-based Philox4x32-10, faster but it does not produce the same graph of the specification
+};
+
+/**
+ * The edges to keep, decided on the scrambled vertex ids as soon as an edge is generated. The source of an edge is
+ * its first vertex
+ */
+struct EdgeFilter {
+    bool self_loops = true; // whether to keep the self-loops (u, u)
+    int64_t source_begin = 0; // keep the edges with the source in [source_begin, source_end)
+    int64_t source_end = INT64_MAX;
+    uint32_t num_partitions = 1; // keep the edges with vertex_partition(source, num_partitions) == partition
+    uint32_t partition = 0;
+
+    // Whether the filter can drop any edge
+    bool active() const { return !self_loops || source_begin > 0 || source_end < INT64_MAX || num_partitions > 1; }
+};
+
+/**
+ * The partition of a vertex for EdgeFilter, in [0, num_partitions): the id mixed by the finaliser of MurmurHash3, so
+ * that the partitions are balanced for any range of ids
+ */
+inline uint32_t vertex_partition(int64_t vertex, uint32_t num_partitions){
+    uint64_t x = static_cast<uint64_t>(vertex);
+    x ^= x >> 33;
+    x *= UINT64_C(0xFF51AFD7ED558CCD);
+    x ^= x >> 33;
+    x *= UINT64_C(0xC4CEB9FE1A85EC53);
+    x ^= x >> 33;
+    return static_cast<uint32_t>(x % num_partitions);
+}
+
+/**
+ * The settings to generate a Kronecker graph
+ */
+struct KroneckerParameters {
+    int scale = 0; // the levels of the recursion, the graph has 2^scale vertices (k^scale with a k x k initiator)
+    uint64_t userseed1 = 2; // first seed, as in make_graph
+    uint64_t userseed2 = 3; // second seed, as in make_graph
+    RandomGenerator rng = RandomGenerator::MRG; // the random number generator
+    bool multilevel_sampler = false; // non-spec, sample four levels of the recursion from a single random value
+    // probabilities a, b, c, d of the quadrants (0, 0), (0, 1), (1, 0), (1, 1), rounded to 1e-4. By default those of the
+    // specification, 0.57, 0.19, 0.19, 0.05, from the constants of graph_generator.h
+    double initiator[4] = {
+            double(INITIATOR_A_NUMERATOR) / INITIATOR_DENOMINATOR,
+            double(INITIATOR_BC_NUMERATOR) / INITIATOR_DENOMINATOR,
+            double(INITIATOR_BC_NUMERATOR) / INITIATOR_DENOMINATOR,
+            double(INITIATOR_DENOMINATOR - INITIATOR_A_NUMERATOR - 2 * INITIATOR_BC_NUMERATOR) / INITIATOR_DENOMINATOR };
+    double noise = 0; // SPK noise in [0, 1], as SPK_NOISE_LEVEL / 10000 in graph_generator.c
+    std::vector<double> initiator_matrix; // non-spec, a k x k initiator in row-major order, k in [2, 16], in place of initiator, see below
+    uint64_t num_vertices = 0; // non-spec, the exact number of vertices, in [2, k^scale], 0 for k^scale, see below
+    bool scramble = true; // non-spec when false, keep the vertex ids of the recursion, without the permutation of scramble()
+    bool directed = false; // non-spec, directed edges from the full initiator, without the clip-and-flip of the undirected graphs
+    bool source_ordered = false; // non-spec, split the edges among the quadrants with multinomial draws, see below
+    uint64_t edgefactor = 16; // the graph has edgefactor * num. vertices edges, only needed by the source-ordered generator
+    weight_policy weight = WEIGHT_POLICY_DEFAULT; // distribution and type of the weights, the default is the specification
+    EdgeFilter filter; // non-spec, the edges to keep, all by default
+    const std::vector<double>* degree_sequence = nullptr; // non-spec, Chung-Lu engine: the expected degree of each vertex, not owned
+    double degree_exponent = 2.5; // non-spec, Chung-Lu engine: the exponent of the power-law degrees, without a degree_sequence
+};
+
+/**
+ * Generate the edges [start_edge, end_edge) of the graph, writing them into edges[0, end_edge - start_edge) and their
+ * weights into weights[0, end_edge - start_edge), an array of the type of params.weight (float by default). With the
+ * default parameters, the result is the same of generate_kronecker_range. For unweighted graphs, weights can be
+ * nullptr: the weights are not drawn, and the edges are the same.
+ *
+ * The edges dropped by params.filter are removed while they are generated: the edges kept are compacted at the start
+ * of the arrays, in the same order, and the function returns their number, end_edge - start_edge without a filter. The
+ * arrays must still have room for end_edge - start_edge edges.
+ *
+ * With source_ordered, the edges are not drawn one at a time, but the whole budget of edgefactor * 2^scale edges is
+ * split recursively among the quadrants, and the edges come out sorted by source. The source of an
+ * edge is the endpoint the recursion assigned to the row of the initiator, there is no clip-and-flip: the edges have
+ * the distribution of the directed generators and, for b == c as in the specification, the distribution of the
+ * undirected edges is the same of the other generators.
+ *
+ * With initiator_matrix, or a num_vertices other than 2^scale, the generalised engine draws the cell of the k x k
+ * initiator of each level with an alias table and appends its row and column, as digits in base k, to the source and
+ * the target. The edges with a vertex >= num_vertices are drawn again, from the next values of the random stream of the
+ * same edge, so any range of edges is still generated on its own. The rejection rate grows as num_vertices gets smaller
+ * than k^scale, the scale should be the smallest with k^scale >= num_vertices. The 2x2 initiator, with its noise, can
+ * be used with any num_vertices too. The generalised engine does not support source_ordered nor multilevel_sampler,
+ * and the graph is not the one of the specification.
+ */
+int64_t generate_kronecker(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+
+/**
+ * The permutation of the vertex ids of generate_kronecker, for the seeds and the size of the parameters: scramble maps
+ * the position of a vertex in the recursion to its id in the edge list, inverse maps the id back, so that the tools can
+ * translate between the two spaces without generating the graph. For a number of vertices that is not a power of two,
+ * the ids are permuted on ceil(log2(num_vertices)) bits until they fall in [0, num_vertices), as in the generalised
+ * engine. Without params.scramble, both are the identity.
+ */
+class VertexScrambler {
+    uint64_t m_num_vertices; // k^scale or params.num_vertices
+    int m_num_bits; // ceil(log2(m_num_vertices))
+    uint64_t m_val0; // as in make_scramble_values
+    uint64_t m_val1;
+    bool m_enabled; // params.scramble
+
+public:
+    // Throws invalid_argument if the scale, the initiator or the number of vertices are not valid
+    VertexScrambler(const KroneckerParameters& params);
+
+    // The id in the edge list of the vertex in [0, num_vertices)
+    int64_t scramble(int64_t vertex) const;
+
+    // The vertex of the id in [0, num_vertices)
+    int64_t inverse(int64_t id) const;
+
+    uint64_t num_vertices() const { return m_num_vertices; }
+};
+
+/**
+ * The state a graph engine derives from a set of parameters (the seeds, the tables and the samplers), built once, from
+ * which any range of edges is then generated without building it again: the shards, the chunks of the streamed output
+ * and the blocks of EdgeStream only pay for their own edges. The object is immutable, and its methods can be called
+ * concurrently. See GraphEngine::prepare in graph_engine.hpp.
+ */
+class EdgeGenerator {
+public:
+    virtual ~EdgeGenerator() = default;
+
+    // The number of vertices of the graph
+    virtual uint64_t num_vertices() const = 0;
+
+    // As generate_kronecker, for the parameters the generator was built for
+    virtual int64_t edges(int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights) const = 0;
+};
+
+/**
+ * Random access to the edges of generate_kronecker: the random stream of an edge only depends on the seeds and on the
+ * index of the edge, so edge(i) computes the edge i on its own, and edges(first, count) any window of the graph, without
+ * generating the edges before it. The state derived from the parameters (the seed of the RNG, the values of the
+ * scramble, the initiator tables and the samplers) is computed once by the constructor, rather than at each call of
+ * generate_kronecker. The object is immutable, and its methods can be called concurrently.
+ *
+ * The graph has edgefactor * num_vertices edges. With source_ordered, the constructor splits the edges among all the
+ * sources, in O(num_vertices) time and memory, and edge(i) then generates the row of the edge i.
+ */
+class KroneckerGraph {
+public:
+    // The generator of a kernel set, see make_kronecker_graph in kernel_dispatch.hpp
+    // The number of vertices is k^scale or params.num_vertices
+    class Generator : public EdgeGenerator {
+    public:
+        // The edge index, ignoring the filter of the parameters, and its weight into weight[0] unless it is nullptr
+        virtual void edge(int64_t index, packed_edge* edge, void* weight) const = 0;
+    };
+
+private:
+    std::unique_ptr<Generator> m_generator;
+    int64_t m_num_edges; // edgefactor * num_vertices
+
+public:
+    // Throws invalid_argument if the parameters are not valid, as generate_kronecker
+    KroneckerGraph(const KroneckerParameters& params);
+
+    // The edge index in [0, num_edges), and its weight into weight[0], of the type of params.weight, unless it is
+    // nullptr. The filter of the parameters does not apply
+    packed_edge edge(int64_t index, void* weight = nullptr) const;
+
+    // The edges [first, first + count), as generate_kronecker(params, first, first + count, edges, weights): returns
+    // the number of edges kept by the filter, compacted at the start of the arrays
+    int64_t edges(int64_t first, int64_t count, packed_edge* edges, void* weights = nullptr) const;
+
+    int64_t num_edges() const { return m_num_edges; }
+
+    uint64_t num_vertices() const { return m_generator->num_vertices(); }
+};
+
+/**
+ * The edges of a KroneckerGraph, in order, one block of a chosen size at a time, for the consumers that feed them into
+ * their own ingestion rather than allocating the whole edge list:
+ *
+ *     EdgeStream stream { params, block_size };
+ *     for(EdgeStream::Block& block : stream){
+ *         for(const packed_edge& edge : block){ ... }
+ *     }
+ *
+ * Each block is generated in parallel, as generate_kronecker(params, first_edge, end_edge, ...), into the arrays of the
+ * block the iterator returns, reused from one block to the next: the memory is that of one block whatever the scale.
+ * A consumer can also take a block with std::move, the next one is then generated into new arrays. The iterators of a
+ * stream share its block, a stream is traversed by one loop at a time. Concurrent consumers can instead call
+ * generate_block, with blocks of their own.
+ */
+class EdgeStream {
+public:
+    // The edges [first_edge, end_edge) of the graph, those kept by the filter of the parameters
+    class Block {
+        friend class EdgeStream;
+        int64_t m_first_edge { 0 };
+        int64_t m_end_edge { 0 };
+        int64_t m_size { 0 }; // the edges kept by the filter
+        int64_t m_capacity { 0 }; // the edges m_edges can hold
+        size_t m_weights_capacity { 0 }; // the bytes of m_weights
+        std::unique_ptr<packed_edge[]> m_edges;
+        std::unique_ptr<char[]> m_weights; // an array of the type of params.weight, nullptr for the unweighted streams
+
+    public:
+        // The range of edges of the graph in the block
+        int64_t first_edge() const { return m_first_edge; }
+        int64_t end_edge() const { return m_end_edge; }
+
+        // The edges in the block, end_edge() - first_edge() without a filter
+        int64_t size() const { return m_size; }
+
+        // The edges, and their weights, of the type of params.weight, or nullptr for the unweighted streams
+        packed_edge* edges() { return m_edges.get(); }
+        const packed_edge* edges() const { return m_edges.get(); }
+        void* weights() { return m_weights.get(); }
+        const void* weights() const { return m_weights.get(); }
+
+        packed_edge* begin() { return m_edges.get(); }
+        packed_edge* end() { return m_edges.get() + m_size; }
+        const packed_edge* begin() const { return m_edges.get(); }
+        const packed_edge* end() const { return m_edges.get() + m_size; }
+    };
+
+    // An input iterator over the blocks, generating a block as it moves onto it
+    class Iterator {
+        EdgeStream* m_stream;
+        int64_t m_index; // the index of the current block, num_blocks() at the end
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Block;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Block*;
+        using reference = Block&;
+
+        Iterator(EdgeStream* stream, int64_t index) : m_stream(stream), m_index(index) { }
+        Block& operator*() const { return m_stream->m_block; }
+        Block* operator->() const { return &m_stream->m_block; }
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return m_stream == other.m_stream && m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+private:
+    KroneckerGraph m_graph;
+    int64_t m_block_size; // the edges per block, the last one can be shorter
+    size_t m_weight_size; // bytes per weight, 0 for the unweighted streams
+    Block m_block; // the block of the iterators
+
+public:
+    static constexpr int64_t DEFAULT_BLOCK_SIZE = INT64_C(1) << 20;
+
+    // The edges of the graph of the parameters, in blocks of block_size edges, with their weights unless weighted is
+    // false. Throws invalid_argument if the parameters are not valid, as KroneckerGraph, or block_size is not positive
+    EdgeStream(const KroneckerParameters& params, int64_t block_size = DEFAULT_BLOCK_SIZE, bool weighted = true);
+
+    // The Graph500 graph of the given scale, edge factor and seeds, as make_graph, with its weights
+    EdgeStream(int scale, uint64_t edgefactor, uint64_t userseed1, uint64_t userseed2, int64_t block_size = DEFAULT_BLOCK_SIZE);
+
+    // Generate the first block, or the end for a stream without edges
+    Iterator begin();
+    Iterator end();
+
+    // Generate the block index, in [0, num_blocks()), into block, allocating its arrays if they are too small or
+    // were moved away. It can be called concurrently with different blocks
+    void generate_block(int64_t index, Block& block) const;
+
+    int64_t block_size() const { return m_block_size; }
+    int64_t num_blocks() const { return (m_graph.num_edges() + m_block_size -1) / m_block_size; }
+    int64_t num_edges() const { return m_graph.num_edges(); }
+    const KroneckerGraph& graph() const { return m_graph; }
+};
@@ -15,25 +15,48 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstdio> // sscanf
 #include <cstdlib> // abort
 #include <cstring>
 #include <fstream>
+#include <future>
 #include <getopt.h> // getopt_long
+#include <iomanip> // setprecision
 #include <iostream>
 #include <memory>
 #include <limits>
+#include <map>
+#include <omp.h>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <strings.h> // strcasecmp
+#include <sys/stat.h> // stat
 
 #include "third-party/graph500_generator/graph_generator.h"
 #include "third-party/graph500_generator/utils.h"
 
 #include "csr_representation.hpp"
+#include "graph_engine.hpp"
+#include "kernel_dispatch.hpp"
+#include "kronecker.hpp"
+#if defined(KRONGEN_MPI)
+#include <mpi.h>
+#include "distributed_csr.hpp"
+#endif
 
 using namespace std;
 
+#if defined(KRONGEN_MPI)
+using GraphCsr = DistributedCsr; // krongen-mpi, each rank stores the rows of its block of vertices
+#else
+using GraphCsr = CsrRepresentation;
+#endif
+
 enum class OutputGraphType {
-    PLAIN, // each line is an edge with the form: src dst weight
+    PLAIN, // each line is an edge with the form: src dst weight, or src dst for unweighted graphs
     METIS, // the format specified the user manual of the METIS Graph Partitiones v5
 };
 
@@ -42,63 +65,241 @@ enum class OutputGraphType {
  * po_ = program options
  */
 uint64_t po_edgefactor = 16; // avg num. of edges per vertex
-bool po_int32 = false; // convert the weights into 4 byte signer integers
+bool po_int32 = false; // legacy, weights as 4 byte signed integers in [0, 2^21), converted from the floats as before
 OutputGraphType po_output_type = OutputGraphType::PLAIN; // the format the graph is serialised
 const char* po_path_output; // where to store the produced graph
+const char* po_path_extend_from = nullptr; // non-spec, a plain edge list of the same graph with fewer edges, to extend
+bool po_sharded = false; // whether only a slice of the edges is generated, with --part or --edge-range
+uint64_t po_part[2] = { 0, 0 }; // --part i/N, the slice i of N, N = 0 without --part
+int64_t po_edge_range[2] = { 0, -1 }; // --edge-range start:end, -1 for the last edge of the graph
+int64_t po_first_edge = 0; // the slice of the edges to generate, [po_first_edge, po_end_edge)
+int64_t po_end_edge = 0;
+bool po_merge = false; // non-spec, join the shards of po_path_manifests into the output rather than generating a graph
+vector<const char*> po_path_manifests; // the manifests of the shards to merge
+uint64_t po_chunk_size = UINT64_C(1) << 20; // non-spec, edges per thread in each chunk of the plain output, streamed
+RandomGenerator po_rng = RandomGenerator::MRG; // the random number generator to create the edges
+const GraphEngine* po_engine = graph_engines(nullptr); // the graph model, Kronecker by default
+bool po_kronecker_options = false; // whether any option of the Kronecker model only was given
+bool po_fast_sampler = false; // non-spec, sample multiple levels of the recursion from a single random value
+double po_initiator[4] = { // probabilities a, b, c, d of the initiator matrix, those of KroneckerParameters by default
+        KroneckerParameters{}.initiator[0], KroneckerParameters{}.initiator[1], KroneckerParameters{}.initiator[2], KroneckerParameters{}.initiator[3] };
+vector<double> po_initiator_matrix; // non-spec, a k x k initiator, row-major, empty for the 2x2 initiator above
+uint64_t po_num_vertices = 0; // non-spec, the exact number of vertices, 0 for k^scale
+uint64_t po_num_edges = 0; // edgefactor * num. vertices, or set by the degree sequence of the Chung-Lu model
+const char* po_path_degrees = nullptr; // non-spec, Chung-Lu model, the file with the expected degree of each vertex
+vector<double> po_degrees; // the content of po_path_degrees
+double po_degree_exponent = 2.5; // non-spec, Chung-Lu model, the exponent of the power-law degrees
+bool po_chung_lu_options = false; // whether any option of the Chung-Lu model only was given
+double po_noise = 0; // SPK noise
+bool po_source_ordered = false; // non-spec, split the edges among the quadrants with multinomial draws, sorted by source
+bool po_scramble = true; // non-spec when false, keep the vertex ids of the Kronecker recursion
+bool po_directed = false; // non-spec, generate a directed graph, without the clip-and-flip
+bool po_in_edges = false; // for directed graphs, also store the in-edges (CSC) of the vertices
+bool po_weights = true; // whether the edges have weights, false for BFS-only workloads
+weight_policy po_weight = WEIGHT_POLICY_DEFAULT; // distribution and type of the weights
+bool po_weight_range = false; // whether the range of the uniform weights was given
+bool po_weight_options = false; // whether any of --int32, --weights or --weight-type was given
+EdgeFilter po_filter; // non-spec, the edges to keep: without self-loops, in a range of sources or in a partition
 int po_scale; // scale of the graph
 
 // Function prototypes
-static void save_plain(uint64_t num_edges, packed_edge* edges, float* weights);
+static void save_plain(uint64_t num_edges, packed_edge* edges, void* weights);
+static void write_edge_line(ostream& out, const packed_edge* edges, const void* weights, uint64_t index);
+static void save_graph(uint64_t num_edges, packed_edge* edges, void* weights);
+static int64_t stream_plain(const KroneckerParameters& params, int64_t first_edge, int64_t end_edge, bool append);
+static int64_t copy_prefix(const KroneckerParameters& params);
+static int64_t load_prefix(const KroneckerParameters& params, packed_edge* edges, void* weights);
+static void save_manifest(int64_t first_edge, int64_t end_edge, int64_t num_edges);
+static void merge_shards();
+static OutputGraphType output_type(const char* path);
+static string in_edges_path(const char* path);
+static string insert_before_extension(const char* path, const string& tag);
+#if defined(KRONGEN_MPI)
+static void init_mpi(int* argc, char** argv[]);
+#endif
 static void print_help(const char* program_name);
 static void parse_program_options(int argc, char* argv[]);
+static void parse_weight_distribution(const char* arg);
+static void load_degree_sequence(const char* path);
 
 
 /**
  * Kronecker graph generator
  */
 int main(int argc, char* argv[]){
+#if defined(KRONGEN_MPI)
+    init_mpi(&argc, &argv);
+#endif
     parse_program_options(argc, argv);
-    cout << "Scale: " << po_scale << ", edge factor: " << po_edgefactor << ", output: " << po_path_output << "\n";
+    if(po_merge){
+        merge_shards();
+        cout << "Done\n";
+        return 0;
+    }
+    cout << "Model: " << po_engine->name << ", scale: " << po_scale << ", vertices: " << po_num_vertices << ", edge factor: " << po_edgefactor << (po_directed ? ", directed" : "") << ", output: " << po_path_output << "\n";
+    const char* kernel_set_name = kernel_set().name; // select the kernel set before printing
+    cout << "Kernel set: " << kernel_set_name << "\n";
+    if(po_sharded){ cout << "Shard: edges [" << po_first_edge << ", " << po_end_edge << ") of " << po_num_edges << "\n"; }
+#if defined(KRONGEN_MPI)
+    cout << "Ranks: " << po_part[1] << ", edges of the rank 0: [" << po_first_edge << ", " << po_end_edge << ") of " << po_num_edges << "\n";
+#endif
 
     cout << "Generating the graph..." << endl;
 
-    // as in make_graph(int log_numverts, int64_t M, uint64_t userseed1, uint64_t userseed2, int64_t* nedges_ptr_in, packed_edge** result_ptr_in)
-    int64_t num_edges = po_edgefactor << po_scale;
-    packed_edge* edges = (packed_edge*) xmalloc(num_edges * sizeof(packed_edge));
-    float* weights = (float*) xmalloc(num_edges * sizeof(float));
-    uint_fast32_t seeds[5]; make_mrg_seed(2, 3, seeds);
-    generate_kronecker_range(seeds, po_scale, 0, num_edges, edges, weights);
+    KroneckerParameters params;
+    params.scale = po_scale;
+    params.rng = po_rng;
+    params.multilevel_sampler = po_fast_sampler;
+    for(int i = 0; i < 4; i++){ params.initiator[i] = po_initiator[i]; }
+    params.initiator_matrix = po_initiator_matrix;
+    params.num_vertices = po_num_vertices;
+    params.degree_sequence = po_path_degrees != nullptr ? &po_degrees : nullptr;
+    params.degree_exponent = po_degree_exponent;
+    params.noise = po_noise;
+    params.source_ordered = po_source_ordered;
+    params.directed = po_directed;
+    params.scramble = po_scramble;
+    params.edgefactor = po_edgefactor;
+    params.weight = po_weight;
+    params.filter = po_filter;
+
+    // With --extend-from, the edges [0, first_edge) come from the edge list given. The plain output only needs the
+    // edges [first_edge, end_edge), streamed in chunks and appended to a copy of the list, the other outputs need the
+    // whole graph in memory. A shard is the plain edge list of the edges [first_edge, end_edge) alone
+    int64_t first_edge = po_first_edge;
+    const int64_t end_edge = po_end_edge;
+    const bool whole_graph = po_output_type != OutputGraphType::PLAIN || po_in_edges;
+    const bool append = po_path_extend_from != nullptr && !whole_graph;
+    if(append){ first_edge = copy_prefix(params); }
+
+    int64_t num_edges = 0;
+    if(!whole_graph){
+        if(po_path_extend_from != nullptr){ cout << "Extending `" << po_path_extend_from << "' with the edges [" << first_edge << ", " << end_edge << ")\n"; }
+        num_edges = stream_plain(params, first_edge, end_edge, append);
+        if(po_filter.active()){ cout << "Edges kept by the filter: " << num_edges << "\n"; }
+    } else {
+        // as in make_graph(int log_numverts, int64_t M, uint64_t userseed1, uint64_t userseed2, int64_t* nedges_ptr_in, packed_edge** result_ptr_in)
+        num_edges = end_edge - first_edge;
+        packed_edge* edges = (packed_edge*) xmalloc(num_edges * sizeof(packed_edge));
+        void* weights = po_weights ? xmalloc(num_edges * weight_size(po_weight.type)) : nullptr; // nullptr => unweighted graph
+        int64_t offset = 0; // the position of the edge first_edge in the arrays
+        if(po_path_extend_from != nullptr){ first_edge = offset = load_prefix(params, edges, weights); }
+        if(po_path_extend_from != nullptr){ cout << "Extending `" << po_path_extend_from << "' with the edges [" << first_edge << ", " << end_edge << ")\n"; }
+        num_edges = offset + po_engine->generate(params, first_edge, end_edge, edges + offset, weight_at(weights, offset, po_weight.type));
+        if(po_filter.active()){ cout << "Edges kept by the filter: " << num_edges << "\n"; }
+
+        save_graph(num_edges, edges, weights);
+
+        free(weights); weights = nullptr; // nop for unweighted graphs
+        free(edges); edges = nullptr;
+    }
+    if(po_sharded){ save_manifest(first_edge, end_edge, num_edges); }
 
-    // serialise the graph format
+    cout << "Done\n";
+    return 0;
+}
+
+// Serialise the graph in the format of the output, and its in-edges with --in-edges
+static void save_graph(uint64_t num_edges, packed_edge* edges, void* weights){
     switch(po_output_type){
     case OutputGraphType::PLAIN:
         save_plain(num_edges, edges, weights);
         break;
     case OutputGraphType::METIS: {
-        CsrRepresentation csr {(uint64_t) num_edges, edges, weights};
-        csr.save_metis(po_path_output, po_int32);
+        GraphCsr csr {(uint64_t) num_edges, edges, weights, po_weight.type, po_directed ? CsrType::OUT_EDGES : CsrType::UNDIRECTED, /* sorted by source ? */ po_source_ordered};
+        csr.save_metis(po_path_output);
     } break;
     default:
         cerr << "Invalid graph type: " << (int) po_output_type << endl;
         abort();
     }
 
-    free(weights); weights = nullptr;
-    free(edges); edges = nullptr;
-    cout << "Done\n";
-    return 0;
+    // the in-edges of the directed graph, in the same format
+    if(po_in_edges){
+        string path = in_edges_path(po_path_output);
+        GraphCsr csc {(uint64_t) num_edges, edges, weights, po_weight.type, CsrType::IN_EDGES, /* sorted by source ? */ po_source_ordered};
+        if(po_output_type == OutputGraphType::METIS){
+            csc.save_metis(path.c_str());
+        } else {
+            csc.save_plain(path.c_str());
+        }
+    }
 }
 
 static void print_help(const char* program_name){
     cout << "Generate a Kronecker graph according to the Graph500 specification v3\n";
     cout << "Usage: " << program_name << " [options] <scale> [output.wel]\n";
+#if defined(KRONGEN_MPI)
+    cout << "Run with mpirun: each rank generates a slice of the edges, as --part <rank>/<ranks>, and writes its part of\n";
+    cout << "the graph in <output>.<rank>.<ext>. The plain output is the edge list of the slice. The METIS output and\n";
+    cout << "--in-edges are the rows of a contiguous block of vertices, with the header in the rank 0: the files of the\n";
+    cout << "ranks, in order, make the output of the same graph of krongen\n";
+#endif
     cout << "Program options:\n";
+    cout << "--chunk-size <n>: edges per thread in each chunk of the plain output, generated while the previous one is\n";
+    cout << "                  written, in memory proportional to n and the threads, whatever the scale (def. 2^20)\n";
+    cout << "--directed      : generate a directed graph, from the full initiator without the clip-and-flip. The METIS\n";
+    cout << "                  output lists the out-edges of each vertex\n";
+    cout << "--degree-exponent <g>: for chung-lu, the exponent g > 1 of the power-law expected degrees, w_v = (v +1)^(-1/(g-1))\n";
+    cout << "                  scaled to the edge factor (def. 2.5)\n";
+    cout << "--degrees <file>: for chung-lu, the expected degree of each vertex, one per line, in place of the power law. The\n";
+    cout << "                  number of vertices and edges come from the file, the scale is ignored\n";
     cout << "-e --edgefactor : avg. num. edges per vertex (def. 16)\n";
+    cout << "--extend-from <file>: reuse the plain edge list of the same graph with a lower edge factor, as the first\n";
+    cout << "                  edges of this one, and only generate the edges after them. The edge i does not depend on\n";
+    cout << "                  the edge factor, except with --source-ordered. Only a plain edge list is accepted, not a\n";
+    cout << "                  METIS graph (.graph, .metis), whose edges are sorted by vertex rather than in the order\n";
+    cout << "                  they were generated. The output can be the edge list itself, extended in place\n";
+    cout << "--edge-range <start:end>: generate only the edges [start, end) of the graph, a shard, into a plain edge list,\n";
+    cout << "                  and describe it in <output>.manifest, for --merge\n";
+    cout << "--fast-sampler  : sample four levels of the recursion from a single random number, with precomputed tables.\n";
+    cout << "                  Same distribution of the edges, but not the graph of the specification\n";
     cout << "-h --help       : display the help menu\n";
-    cout << "--int32         : convert the weights into ints\n\n";
+    cout << "--in-edges      : with --directed, also store the in-edges of each vertex, in <output>.in.<ext>. The plain\n";
+    cout << "                  output is then the edge list sorted by destination\n";
+    cout << "--initiator <a,b,c,d> : probabilities of the initiator matrix, summing to 1 (def. 0.57,0.19,0.19,0.05). A list\n";
+    cout << "                  of k x k probabilities, k in [3, 16], row by row, is a k x k initiator: the graph has k^scale\n";
+    cout << "                  vertices, and it is not the graph of the specification\n";
+    cout << "--int32         : legacy, weights as 4 byte integers in [0, 2^21), (int) (w * (2^31 -1)) / 1024 for the float\n";
+    cout << "                  weight w in [0, 1). --weight-type int32 --weights uniform:0,2097151 has the same range,\n";
+    cout << "                  with integers drawn from all the bits of the random value\n";
+    cout << "--no-scramble   : keep the vertex ids of the Kronecker recursion, without the permutation of the specification,\n";
+    cout << "                  to preserve their locality\n";
+    cout << "--no-self-loops : drop the self-loops (u, u) while the edges are generated\n";
+    cout << "--no-weights    : generate an unweighted graph, the output omits the weights. Same edges of the weighted graph\n";
+    cout << "--merge         : join shards, with the usage " << program_name << " --merge <output> <shard.manifest>...\n";
+    cout << "                  The shards must be of the same graph and cover all its edges. The output is the edge list\n";
+    cout << "                  or the METIS graph of the whole graph, with its in-edges for --in-edges\n";
+    cout << "--model <name>  : the graph model, ";
+    int num_engines = 0;
+    const GraphEngine* engines = graph_engines(&num_engines);
+    for(int i = 0; i < num_engines; i++){
+        cout << (i == 0 ? "" : (i +1 < num_engines) ? ", " : " or ") << "`" << engines[i].name << "'" << (i == 0 ? " (def.)" : "");
+    }
+    cout << ":\n";
+    for(int i = 0; i < num_engines; i++){ cout << "                  * " << engines[i].name << ": " << engines[i].description << "\n"; }
+    cout << "                  The options --fast-sampler, --initiator, --noise, --no-scramble and --source-ordered only apply to\n";
+    cout << "                  kronecker\n";
+    cout << "--noise <x>     : SPK noise in [0, 1], the per level perturbation of b and c (def. 0)\n";
+    cout << "--part <i/N>    : generate only the slice i of N, in [0, N), of the edges, as --edge-range\n";
+    cout << "--partition <i/N>: only keep the edges whose source hashes to the partition i of N, in [0, N)\n";
+    cout << "--rng <name>    : random number generator, either `mrg' (def.), as in the Graph500 specification, or\n";
+    cout << "                  `philox', counter-based and faster, but it does not produce the graph of the specification\n";
+    cout << "--source-ordered: split the edges among the quadrants of the recursion with multinomial draws, rather than\n";
+    cout << "                  one edge at a time. The edges come out sorted by source and the conversion to METIS is\n";
+    cout << "                  faster. Same distribution of the undirected edges for b = c, but not the graph of the specification\n";
+    cout << "--source-range <a,b>: only keep the edges whose source, the first vertex, is in [a, b)\n";
+    cout << "--vertices <n>  : the exact number of vertices, in [2, k^scale], for a k x k initiator (k = 2 by default). The\n";
+    cout << "                  edges with a vertex >= n are drawn again: the scale should be the smallest with k^scale >= n,\n";
+    cout << "                  as the rejections grow with k^scale / n. Not the graph of the specification\n";
+    cout << "--weight-type <t>: type of the weights, either `float' (def.), `int32', `uint16' or `uint8'\n";
+    cout << "--weights <dist>: distribution of the weights, either `uniform[:min,max]', floats in [min, max) (def. [0, 1))\n";
+    cout << "                  or integers in [min, max] (def. [0, max. of the type]), `exponential[:mean]' (def. mean 1), or\n";
+    cout << "                  `lognormal[:mu,sigma]' (def. 0,1). The integer types round the exponential and log-normal\n";
+    cout << "                  values and saturate them to their range\n\n";
     cout << "The program generates a graph with |V| = 2^scale vertices and |E| = 16 * |V|. The output is an edge list in the format: \n";
     cout << "vertex_1 vertex_2 weight\n";
-    cout << "where the weight is a double in [0, 1), generated according to a uniform distribution.\n\n";
+    cout << "where the weight is, by default, a float in [0, 1), generated according to a uniform distribution.\n\n";
     cout << "Graph500 scales:\n";
     cout << "* toy: 26\n" <<
             "* mini: 29\n" <<
@@ -112,14 +313,71 @@ static void parse_program_options(int argc, char* argv[]){
     int getopt_rc = 0;
     struct option long_options[] = {
             /* name, has_arg in (no_argument, required_argument and optional_argument), flag = nullptr, returned value */
+            {"degree-exponent", required_argument, nullptr, 'g'},
+            {"degrees", required_argument, nullptr, 'D'},
+            {"chunk-size", required_argument, nullptr, 'k'},
+            {"directed", no_argument, nullptr, 'd'},
+            {"edge-range", required_argument, nullptr, 'R'},
             {"edgefactor", required_argument, nullptr, 'e'},
+            {"extend-from", required_argument, nullptr, 'X'},
+            {"fast-sampler", no_argument, nullptr, 'f'},
             {"help", no_argument, nullptr, 'h'},
+            {"in-edges", no_argument, nullptr, 'c'},
+            {"initiator", required_argument, nullptr, 'a'},
             {"int32", no_argument, nullptr, 'i'},
+            {"merge", no_argument, nullptr, 'M'},
+            {"model", required_argument, nullptr, 'm'},
+            {"no-scramble", no_argument, nullptr, 'u'},
+            {"no-self-loops", no_argument, nullptr, 'L'},
+            {"no-weights", no_argument, nullptr, 'w'},
+            {"noise", required_argument, nullptr, 'n'},
+            {"part", required_argument, nullptr, 'p'},
+            {"partition", required_argument, nullptr, 'P'},
+            {"rng", required_argument, nullptr, 'r'},
+            {"source-ordered", no_argument, nullptr, 's'},
+            {"source-range", required_argument, nullptr, 'S'},
+            {"vertices", required_argument, nullptr, 'V'},
+            {"weight-type", required_argument, nullptr, 'T'},
+            {"weights", required_argument, nullptr, 'W'},
             {0, 0, 0, 0} // keep at the end
     };
     int option_index = -1;
     while((getopt_rc = getopt_long(argc, argv, "e:hv", long_options, &option_index)) != -1){
         switch(getopt_rc){
+        case 'a': {
+            po_kronecker_options = true;
+            vector<double> values;
+            const char* value = optarg;
+            double probability; int length = 0;
+            while(sscanf(value, "%lf%n", &probability, &length) == 1){
+                values.push_back(probability);
+                value += length;
+                if(*value != ','){ break; }
+                value++;
+            }
+            int order = 2;
+            while(order * order < (int) values.size()){ order++; }
+            if(*value != '\0' || values.size() < 4 || order * order != (int) values.size()){
+                cerr << "ERROR: Invalid value for the initiator: " << optarg << ", expected a,b,c,d or the k x k probabilities of a larger initiator" << endl;
+                abort();
+            }
+            if(order == 2){
+                copy(values.begin(), values.end(), po_initiator);
+                po_initiator_matrix.clear();
+            } else {
+                po_initiator_matrix = values;
+            }
+        } break;
+        case 'c':
+            po_in_edges = true;
+            break;
+        case 'd':
+            po_directed = true;
+            break;
+        case 'D':
+            po_path_degrees = optarg;
+            po_chung_lu_options = true;
+            break;
         case 'e':{
             int user_edge_factor = atoi(optarg);
             if(user_edge_factor <= 0){
@@ -128,11 +386,140 @@ static void parse_program_options(int argc, char* argv[]){
             }
             po_edgefactor = user_edge_factor;
         } break;
+        case 'k': {
+            long long chunk_size = 0;
+            if(sscanf(optarg, "%lld", &chunk_size) != 1 || chunk_size <= 0){
+                cerr << "ERROR: Invalid value for the size of the chunks: " << optarg << ", expected a positive number of edges" << endl;
+                abort();
+            }
+            po_chunk_size = chunk_size;
+        } break;
+        case 'g':
+            po_degree_exponent = atof(optarg);
+            if(!(po_degree_exponent > 1)){
+                cerr << "ERROR: Invalid value for the degree exponent: " << optarg << ", expected a value > 1" << endl;
+                abort();
+            }
+            po_chung_lu_options = true;
+            break;
+        case 'f':
+            po_fast_sampler = true;
+            po_kronecker_options = true;
+            break;
         case 'h':
             print_help(argv[0]);
             exit(EXIT_SUCCESS);
         case 'i':
             po_int32 = true;
+            po_weight.type = WEIGHT_INT32;
+            po_weight_options = true;
+            break;
+        case 'm':
+            po_engine = find_graph_engine(optarg);
+            if(po_engine == nullptr){
+                cerr << "ERROR: Invalid value for the graph model: " << optarg << ", see --help for the available models" << endl;
+                abort();
+            }
+            break;
+        case 'n':
+            po_noise = atof(optarg);
+            po_kronecker_options = true;
+            if(po_noise < 0 || po_noise > 1){
+                cerr << "ERROR: Invalid value for the noise: " << optarg << ", expected a value in [0, 1]" << endl;
+                abort();
+            }
+            break;
+        case 'r':
+            if(strcasecmp(optarg, "mrg") == 0){
+                po_rng = RandomGenerator::MRG;
+            } else if(strcasecmp(optarg, "philox") == 0){
+                po_rng = RandomGenerator::PHILOX;
+            } else {
+                cerr << "ERROR: Invalid value for the random number generator: " << optarg << ", expected either `mrg' or `philox'" << endl;
+                abort();
+            }
+            break;
+        case 's':
+            po_source_ordered = true;
+            po_kronecker_options = true;
+            break;
+        case 'u':
+            po_scramble = false;
+            po_kronecker_options = true;
+            break;
+        case 'w':
+            po_weights = false;
+            break;
+        case 'L':
+            po_filter.self_loops = false;
+            break;
+        case 'P':
+            if(sscanf(optarg, "%u/%u", &po_filter.partition, &po_filter.num_partitions) != 2 || po_filter.num_partitions == 0 || po_filter.partition >= po_filter.num_partitions){
+                cerr << "ERROR: Invalid value for the partition: " << optarg << ", expected i/N with 0 <= i < N" << endl;
+                abort();
+            }
+            break;
+        case 'S': {
+            long long begin = 0, end = 0;
+            if(sscanf(optarg, "%lld,%lld", &begin, &end) != 2 || begin < 0 || begin > end){
+                cerr << "ERROR: Invalid value for the range of the sources: " << optarg << ", expected a,b with 0 <= a <= b" << endl;
+                abort();
+            }
+            po_filter.source_begin = begin;
+            po_filter.source_end = end;
+        } break;
+        case 'T':
+            if(strcasecmp(optarg, "float") == 0){
+                po_weight.type = WEIGHT_FLOAT;
+            } else if(strcasecmp(optarg, "int32") == 0){
+                po_weight.type = WEIGHT_INT32;
+            } else if(strcasecmp(optarg, "uint16") == 0){
+                po_weight.type = WEIGHT_UINT16;
+            } else if(strcasecmp(optarg, "uint8") == 0){
+                po_weight.type = WEIGHT_UINT8;
+            } else {
+                cerr << "ERROR: Invalid value for the type of the weights: " << optarg << ", expected `float', `int32', `uint16' or `uint8'" << endl;
+                abort();
+            }
+            po_weight_options = true;
+            break;
+        case 'V': {
+            long long num_vertices = 0;
+            if(sscanf(optarg, "%lld", &num_vertices) != 1 || num_vertices < 2){
+                cerr << "ERROR: Invalid value for the number of vertices: " << optarg << ", expected at least 2" << endl;
+                abort();
+            }
+            po_num_vertices = num_vertices;
+        } break;
+        case 'M':
+            po_merge = true;
+            break;
+        case 'p': {
+            unsigned long long index = 0, num_parts = 0;
+            if(sscanf(optarg, "%llu/%llu", &index, &num_parts) != 2 || num_parts == 0 || index >= num_parts){
+                cerr << "ERROR: Invalid value for the part: " << optarg << ", expected i/N with 0 <= i < N" << endl;
+                abort();
+            }
+            po_part[0] = index;
+            po_part[1] = num_parts;
+            po_sharded = true;
+        } break;
+        case 'R': {
+            long long begin = 0, end = 0;
+            if(sscanf(optarg, "%lld:%lld", &begin, &end) != 2 || begin < 0 || begin > end){
+                cerr << "ERROR: Invalid value for the range of the edges: " << optarg << ", expected start:end with 0 <= start <= end" << endl;
+                abort();
+            }
+            po_edge_range[0] = begin;
+            po_edge_range[1] = end;
+            po_sharded = true;
+        } break;
+        case 'X':
+            po_path_extend_from = optarg;
+            break;
+        case 'W':
+            parse_weight_distribution(optarg);
+            po_weight_options = true;
             break;
         default:
             cerr << "ERROR: Invalid argument: ";
@@ -146,6 +533,112 @@ static void parse_program_options(int argc, char* argv[]){
         }
     };
 
+    if(po_kronecker_options && strcmp(po_engine->name, "kronecker") != 0){
+        cerr << "ERROR: The options --fast-sampler, --initiator, --noise, --no-scramble and --source-ordered only apply to the Kronecker model" << endl;
+        abort();
+    }
+
+    if(po_chung_lu_options && strcmp(po_engine->name, "chung-lu") != 0){
+        cerr << "ERROR: The options --degrees and --degree-exponent only apply to the Chung-Lu model" << endl;
+        abort();
+    }
+
+    if(po_path_degrees != nullptr && po_num_vertices != 0){
+        cerr << "ERROR: The options --degrees and --vertices cannot be used together" << endl;
+        abort();
+    }
+
+    if(po_source_ordered && po_fast_sampler){
+        cerr << "ERROR: The options --fast-sampler and --source-ordered cannot be used together" << endl;
+        abort();
+    }
+
+    if(po_path_extend_from != nullptr && output_type(po_path_extend_from) != OutputGraphType::PLAIN){
+        cerr << "ERROR: The option --extend-from only accepts a plain edge list, not the METIS graph " << po_path_extend_from << ", whose edges are not in the order of the generation" << endl;
+        abort();
+    }
+    if(po_path_extend_from != nullptr && (po_source_ordered || po_filter.active())){
+        cerr << "ERROR: The option --extend-from cannot be used with --source-ordered, which splits the whole budget of edges, nor with the filters --no-self-loops, --partition and --source-range" << endl;
+        abort();
+    }
+
+#if defined(KRONGEN_MPI)
+    if(po_sharded || po_merge || po_path_extend_from != nullptr){
+        cerr << "ERROR: The options --part, --edge-range, --merge and --extend-from do not apply to krongen-mpi, the edges are split among the ranks" << endl;
+        abort();
+    }
+#endif
+
+    if(po_part[1] > 0 && po_edge_range[1] >= 0){
+        cerr << "ERROR: The options --part and --edge-range cannot be used together" << endl;
+        abort();
+    }
+
+    if(po_sharded && (po_path_extend_from != nullptr || po_in_edges)){
+        cerr << "ERROR: The options --part and --edge-range cannot be used with --extend-from nor --in-edges, the shards are joined by --merge" << endl;
+        abort();
+    }
+
+    if(po_merge && (po_sharded || po_path_extend_from != nullptr)){
+        cerr << "ERROR: The option --merge cannot be used with --part, --edge-range nor --extend-from" << endl;
+        abort();
+    }
+
+    // --merge <output> <shard.manifest>...: the settings of the graph come from the manifests
+    if(po_merge){
+        if(optind +1 >= argc){
+            cerr << "ERROR: The option --merge expects the output and the manifests of the shards: " << argv[0] << " --merge <output> <shard.manifest>..." << endl;
+            abort();
+        }
+        po_path_output = argv[optind];
+        po_output_type = output_type(po_path_output);
+        for(int i = optind +1; i < argc; i++){ po_path_manifests.push_back(argv[i]); }
+        return;
+    }
+
+    if(po_in_edges && !po_directed){
+        cerr << "ERROR: The option --in-edges requires --directed" << endl;
+        abort();
+    }
+
+    if(po_weight_options && !po_weights){
+        cerr << "ERROR: The option --no-weights cannot be used with --int32, --weights or --weight-type" << endl;
+        abort();
+    }
+
+    if(po_int32 && po_weight.type != WEIGHT_INT32){
+        cerr << "ERROR: The option --int32 conflicts with the given --weight-type" << endl;
+        abort();
+    }
+
+    // --int32 keeps its former output, the conversion of the default float weights
+    if(po_int32){
+        if(po_weight.distribution != WEIGHT_UNIFORM || po_weight_range){
+            cerr << "ERROR: The option --int32 cannot be used with --weights, use --weight-type int32 instead" << endl;
+            abort();
+        }
+        po_weight.distribution = WEIGHT_LEGACY_INT32;
+    }
+
+    // the default range of the uniform integers
+    if(po_weight.distribution == WEIGHT_UNIFORM && !po_weight_range && po_weight.type != WEIGHT_FLOAT){
+        po_weight.min = 0;
+        switch(po_weight.type){
+        case WEIGHT_INT32: po_weight.max = numeric_limits<int32_t>::max(); break;
+        case WEIGHT_UINT16: po_weight.max = numeric_limits<uint16_t>::max(); break;
+        default: po_weight.max = numeric_limits<uint8_t>::max(); break;
+        }
+    }
+
+    if(po_weight.distribution == WEIGHT_UNIFORM && po_weight.type != WEIGHT_FLOAT){
+        double type_min = (po_weight.type == WEIGHT_INT32) ? numeric_limits<int32_t>::min() : 0;
+        double type_max = (po_weight.type == WEIGHT_INT32) ? numeric_limits<int32_t>::max() : (po_weight.type == WEIGHT_UINT16) ? numeric_limits<uint16_t>::max() : numeric_limits<uint8_t>::max();
+        if(po_weight.min != floor(po_weight.min) || po_weight.max != floor(po_weight.max) || po_weight.min < type_min || po_weight.max > type_max){
+            cerr << "ERROR: The range of the uniform weights must be made of integers representable in their type" << endl;
+            abort();
+        }
+    }
+
     // mandatory arguments not given
     if(optind >= argc){
         print_help(argv[0]);
@@ -174,6 +667,29 @@ static void parse_program_options(int argc, char* argv[]){
         }
     }
 
+    // the vertices of the recursion, k^scale
+    const uint64_t order = po_initiator_matrix.empty() ? 2 : (uint64_t) sqrt((double) po_initiator_matrix.size());
+    uint64_t max_vertices = 1;
+    for(int level = 0; level < po_scale; level++){
+        if(max_vertices > (UINT64_C(1) << 62) / order){
+            cerr << "ERROR: The scale is too large for the initiator, the graph would have more than 2^62 vertices" << endl;
+            abort();
+        }
+        max_vertices *= order;
+    }
+    if(po_num_vertices == 0){
+        po_num_vertices = max_vertices;
+    } else if(po_num_vertices > max_vertices){
+        cerr << "ERROR: The number of vertices " << po_num_vertices << " is not in [2, k^scale] = [2, " << max_vertices << "]" << endl;
+        abort();
+    }
+    if((!po_initiator_matrix.empty() || po_num_vertices != max_vertices) && (po_source_ordered || po_fast_sampler)){
+        cerr << "ERROR: The options --fast-sampler and --source-ordered only support the 2x2 initiator with 2^scale vertices" << endl;
+        abort();
+    }
+    po_num_edges = po_edgefactor * po_num_vertices;
+    if(po_path_degrees != nullptr){ load_degree_sequence(po_path_degrees); }
+
     if(optind +1 >= argc){ // default
         po_path_output = "output.wel";
     } else {
@@ -182,32 +698,167 @@ static void parse_program_options(int argc, char* argv[]){
 
 
     // check the output extension
-    char* file_ext = strrchr(po_path_output, '.');
+    po_output_type = output_type(po_path_output);
+
+    // the slice of the edges of a shard
+    if(po_edge_range[1] >= 0){
+        if(po_edge_range[1] > (int64_t) po_num_edges){
+            cerr << "ERROR: The range of the edges [" << po_edge_range[0] << ", " << po_edge_range[1] << ") exceeds the " << po_num_edges << " edges of the graph" << endl;
+            abort();
+        }
+        po_first_edge = po_edge_range[0];
+        po_end_edge = po_edge_range[1];
+    } else if(po_part[1] == 0){ // the whole graph
+        po_first_edge = 0;
+        po_end_edge = po_num_edges;
+    } else { // as in get_thread_range of graph_generator.c
+        po_first_edge = (uint64_t) ((unsigned __int128) po_num_edges * po_part[0] / po_part[1]);
+        po_end_edge = (uint64_t) ((unsigned __int128) po_num_edges * (po_part[0] +1) / po_part[1]);
+    }
+    if(po_sharded && po_output_type != OutputGraphType::PLAIN){
+        cerr << "ERROR: A shard is a plain edge list, build the METIS graph with --merge" << endl;
+        abort();
+    }
+
+#if defined(KRONGEN_MPI)
+    // the part of the graph of the rank: output.graph => output.<rank>.graph
+    static string rank_path;
+    rank_path = insert_before_extension(po_path_output, to_string(po_part[0]));
+    po_path_output = rank_path.c_str();
+#endif
+}
+
+// METIS for the extensions .graph and .metis, the plain edge list otherwise
+static OutputGraphType output_type(const char* path){
+    const char* file_ext = strrchr(path, '.');
     if(file_ext != nullptr){
         file_ext++; // skip the dot
         if(strcmp(file_ext, "graph") == 0 || strcmp(file_ext, "metis") == 0){
-            po_output_type = OutputGraphType::METIS;
+            return OutputGraphType::METIS;
         }
     }
+    return OutputGraphType::PLAIN;
+}
+
 
+// The argument of --weights: uniform[:min,max], exponential[:mean] or lognormal[:mu,sigma]
+static void parse_weight_distribution(const char* arg){
+    const char* params = strchr(arg, ':');
+    string name = (params != nullptr) ? string(arg, params - arg) : string(arg);
+    bool valid = true;
+    if(strcasecmp(name.c_str(), "uniform") == 0){
+        po_weight.distribution = WEIGHT_UNIFORM;
+        if(params != nullptr){
+            valid = sscanf(params +1, "%lf,%lf", &po_weight.min, &po_weight.max) == 2 && po_weight.min <= po_weight.max;
+            po_weight_range = true;
+        }
+    } else if(strcasecmp(name.c_str(), "exponential") == 0){
+        po_weight.distribution = WEIGHT_EXPONENTIAL;
+        if(params != nullptr){
+            valid = sscanf(params +1, "%lf", &po_weight.mean) == 1 && po_weight.mean > 0;
+        }
+    } else if(strcasecmp(name.c_str(), "lognormal") == 0){
+        po_weight.distribution = WEIGHT_LOG_NORMAL;
+        if(params != nullptr){
+            valid = sscanf(params +1, "%lf,%lf", &po_weight.mu, &po_weight.sigma) == 2 && po_weight.sigma >= 0;
+        }
+    } else {
+        valid = false;
+    }
+
+    if(!valid){
+        cerr << "ERROR: Invalid value for the distribution of the weights: " << arg << ", expected `uniform[:min,max]', `exponential[:mean]' or `lognormal[:mu,sigma]'" << endl;
+        abort();
+    }
 }
 
+// The expected degrees of --degrees, one per line. The graph has as many vertices and the edges to match the sum of
+// the degrees: half of it for the undirected graphs, the whole sum of the out-degrees for the directed graphs
+static void load_degree_sequence(const char* path){
+    fstream f(path, ios_base::in);
+    if(!f.good()){
+        cerr << "ERROR: Cannot open the file of the degrees: " << path << endl;
+        abort();
+    }
+    double degree = 0, sum = 0;
+    while(f >> degree){
+        if(degree < 0 || !isfinite(degree)){
+            cerr << "ERROR: Invalid degree in " << path << " for the vertex " << po_degrees.size() << ": " << degree << endl;
+            abort();
+        }
+        po_degrees.push_back(degree);
+        sum += degree;
+    }
+    if(!f.eof()){
+        cerr << "ERROR: Invalid degree in " << path << " for the vertex " << po_degrees.size() << ", expected a number per line" << endl;
+        abort();
+    }
+    if(po_degrees.size() < 2 || !(sum > 0)){
+        cerr << "ERROR: The file " << path << " must give the degrees of at least two vertices, with a sum > 0" << endl;
+        abort();
+    }
+
+    po_num_vertices = po_degrees.size();
+    po_num_edges = (uint64_t) llround(po_directed ? sum : sum / 2);
+}
 
-static void save_plain(uint64_t num_edges, packed_edge* edges, float* weights){
+// The path for the in-edges of a directed graph: output.graph => output.in.graph
+static string in_edges_path(const char* path){
+    return insert_before_extension(path, "in");
+}
+
+// path.ext => path.tag.ext, or path => path.tag without an extension
+static string insert_before_extension(const char* path, const string& tag){
+    string result = path;
+    size_t dot = result.rfind('.');
+    size_t slash = result.rfind('/');
+    if(dot == string::npos || (slash != string::npos && dot < slash)){
+        return result + "." + tag;
+    } else {
+        return result.insert(dot, "." + tag);
+    }
+}
+
+#if defined(KRONGEN_MPI)
+// Start MPI. The rank generates the slice <rank>/<ranks> of the edges, as --part, and only the rank 0 prints its
+// progress. OpenMP threads run inside the ranks, only the main thread calls MPI
+static void init_mpi(int* argc, char** argv[]){
+    int thread_level = 0;
+    MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &thread_level);
+    atexit([](){ int finalized = 0; MPI_Finalized(&finalized); if(!finalized) MPI_Finalize(); });
+    if(thread_level < MPI_THREAD_FUNNELED){
+        cerr << "ERROR: The MPI library does not support the thread level MPI_THREAD_FUNNELED" << endl;
+        abort();
+    }
+
+    int rank = 0, num_ranks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+    po_part[0] = rank;
+    po_part[1] = num_ranks;
+    if(rank > 0){ cout.setstate(ios_base::failbit); }
+}
+#endif
+
+// A line of the plain output: src dst weight, or src dst for unweighted graphs
+static void write_edge_line(ostream& out, const packed_edge* edges, const void* weights, uint64_t index){
+    out << get_v0_from_edge(edges + index) << " " << get_v1_from_edge(edges + index);
+    if(weights != nullptr){
+        out << " ";
+        write_weight(out, weights, index, po_weight.type);
+    }
+    out << "\n";
+}
+
+static void save_plain(uint64_t num_edges, packed_edge* edges, void* weights){
     cout << "[save_plain] Writing the graph in `" << po_path_output << "' ..." << endl;
     fstream f(po_path_output, ios_base::out);
     if(!f.good()) {
         cerr << "Cannot open the file " << po_path_output << endl;
         abort();
     }
-    for(int64_t i = 0; i < num_edges; i++){
-        f << get_v0_from_edge(edges + i) << " " << get_v1_from_edge(edges + i) << " ";
-        if(po_int32){
-            f << static_cast<int32_t>(static_cast<double>(weights[i]) * numeric_limits<int32_t>::max()) / 1024;
-        } else {
-            f << weights[i];
-        }
-        f << "\n";
+    for(uint64_t i = 0; i < num_edges; i++){
+        write_edge_line(f, edges, weights, i);
 
         if(!f.good()){
             cerr << "Error writing in " << po_path_output << endl;
@@ -217,3 +868,390 @@ static void save_plain(uint64_t num_edges, packed_edge* edges, float* weights){
     f.close();
 }
 
+// The plain output, streamed: the edges [first_edge, end_edge) are generated in chunks of po_chunk_size edges per
+// thread, formatted by the threads into text, and a thread writes each chunk to the output while the next one is being
+// generated. The memory holds one chunk of edges and two of text, independently of the number of edges. Returns the
+// number of edges written, those kept by the filter
+static int64_t stream_plain(const KroneckerParameters& params, int64_t first_edge, int64_t end_edge, bool append){
+    const int num_threads = omp_get_max_threads();
+    const int64_t chunk_size = (int64_t) min<uint64_t>(po_chunk_size * num_threads, max<int64_t>(end_edge - first_edge, 1));
+
+    // The engine, prepared once for all the chunks: the source-ordered rows of the Kronecker model and the tables of
+    // the Chung-Lu model take O(num_vertices) to build
+    unique_ptr<EdgeGenerator> generator { po_engine->prepare(params) };
+
+    cout << "[stream_plain] " << (append ? "Appending" : "Writing") << " the graph in `" << po_path_output << "', in chunks of " << chunk_size << " edges ..." << endl;
+    fstream f(po_path_output, append ? ios_base::out | ios_base::app : ios_base::out);
+    if(!f.good()) {
+        cerr << "Cannot open the file " << po_path_output << endl;
+        abort();
+    }
+
+    unique_ptr<packed_edge[]> edges { new packed_edge[chunk_size] };
+    unique_ptr<char[]> weights { po_weights ? new char[chunk_size * weight_size(po_weight.type)] : nullptr };
+    vector<string> text[2] = { vector<string>(num_threads), vector<string>(num_threads) }; // the chunk of each thread
+    future<void> writer; // writing the previous chunk
+    int64_t num_edges = 0;
+    for(int64_t chunk = 0, start = first_edge; start < end_edge; chunk++, start += chunk_size){
+        const int64_t end = min(start + chunk_size, end_edge);
+        const int64_t num_chunk_edges = generator->edges(start, end, edges.get(), weights.get());
+        num_edges += num_chunk_edges;
+
+        // text[chunk % 2] was written by the writer two chunks ago, already waited for
+        vector<string>& chunk_text = text[chunk % 2];
+        #pragma omp parallel for schedule(static, 1)
+        for(int t = 0; t < num_threads; t++){
+            ostringstream out;
+            for(int64_t i = num_chunk_edges * t / num_threads, i_end = num_chunk_edges * (t +1) / num_threads; i < i_end; i++){
+                write_edge_line(out, edges.get(), weights.get(), i);
+            }
+            chunk_text[t] = out.str();
+        }
+
+        if(writer.valid()){ writer.get(); }
+        writer = async(launch::async, [&f, &chunk_text](){
+            for(const string& lines : chunk_text){
+                f.write(lines.data(), lines.size());
+                if(!f.good()){
+                    cerr << "Error writing in " << po_path_output << endl;
+                    abort();
+                }
+            }
+        });
+    }
+    if(writer.valid()){ writer.get(); }
+    f.close();
+
+    return num_edges;
+}
+
+// The lines of --extend-from checked against the graph: those at the multiples of the stride, evenly spaced, and the
+// last one
+static int64_t prefix_sample_stride(){
+    return max<int64_t>(po_num_vertices / 4, 1);
+}
+
+// Check that the line of --extend-from at the given index is the edge index of the graph, as the plain output prints it
+static void check_prefix_line(EdgeGenerator* generator, int64_t index, const string& line){
+    packed_edge edge;
+    unique_ptr<char[]> weight { new char[weight_size(po_weight.type)] };
+    generator->edges(index, index +1, &edge, po_weights ? weight.get() : nullptr);
+    stringstream expected;
+    write_edge_line(expected, &edge, po_weights ? weight.get() : nullptr, 0);
+    if(expected.str() != line + "\n"){
+        cerr << "ERROR: The edge list " << po_path_extend_from << " is not a prefix of this graph, the line " << index +1 << " is `" << line << "', expected `" << expected.str().substr(0, expected.str().size() -1) << "'. The seeds, the model, its options and the weights must be the same" << endl;
+        abort();
+    }
+}
+
+// The number of edges of --extend-from, those of the same graph with a lower edge factor: a multiple of the vertices,
+// at most the edges of this graph. With --degrees, the degree sequence sets the edges, the same in both graphs
+static void check_prefix_size(int64_t num_lines){
+    if(po_path_degrees != nullptr){
+        if(num_lines != (int64_t) po_num_edges){
+            cerr << "ERROR: The edge list " << po_path_extend_from << " has " << num_lines << " edges, the degree sequence of this graph sets " << po_num_edges << endl;
+            abort();
+        }
+    } else if(num_lines == 0 || num_lines % (int64_t) po_num_vertices != 0 || num_lines > (int64_t) po_num_edges){
+        cerr << "ERROR: The edge list " << po_path_extend_from << " has " << num_lines << " edges, expected the edges of an edge factor in [1, " << po_edgefactor << "], a multiple of the " << po_num_vertices << " vertices" << endl;
+        abort();
+    }
+}
+
+// Check that --extend-from, with num_lines lines, is a prefix of the graph: its size, then the lines sampled and its
+// last line against the edges regenerated
+static void check_prefix(const KroneckerParameters& params, int64_t num_lines, const vector<pair<int64_t, string>>& samples, const string& last_line){
+    check_prefix_size(num_lines);
+    unique_ptr<EdgeGenerator> generator { po_engine->prepare(params) };
+    for(auto& sample : samples){ check_prefix_line(generator.get(), sample.first, sample.second); }
+    check_prefix_line(generator.get(), num_lines -1, last_line);
+}
+
+// Copy the plain edge list at path into out, unless out is nullptr, and return its number of lines, with those at the
+// multiples of stride, and the last one
+static int64_t copy_edge_list(const char* path, fstream* out, int64_t stride, vector<pair<int64_t, string>>* samples, string* last_line){
+    fstream in(path, ios_base::in | ios_base::binary);
+    if(!in.good()){
+        cerr << "Cannot open the file " << path << endl;
+        abort();
+    }
+
+    const size_t buffer_size = 1 << 20;
+    unique_ptr<char[]> buffer { new char[buffer_size] };
+    int64_t num_lines = 0;
+    string line;
+    while(in.read(buffer.get(), buffer_size) || in.gcount() > 0){
+        const char* begin = buffer.get();
+        const char* end = begin + in.gcount();
+        for(const char* p = begin; p < end; ){
+            const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+            if(newline == nullptr){ line.append(p, end); break; }
+            const bool sampled = num_lines % stride == 0;
+            if(sampled || newline +1 == end || memchr(newline +1, '\n', end - newline -1) == nullptr){ // or the last line of the buffer
+                line.append(p, newline);
+                if(sampled){ samples->emplace_back(num_lines, line); }
+                last_line->swap(line);
+            }
+            line.clear();
+            num_lines++;
+            p = newline +1;
+        }
+        if(out != nullptr && !out->write(begin, end - begin)){
+            cerr << "Error writing in " << po_path_output << endl;
+            abort();
+        }
+    }
+    if(!line.empty()){
+        cerr << "ERROR: The last line of " << path << " is truncated" << endl;
+        abort();
+    }
+    return num_lines;
+}
+
+// Parse the plain edge list at path into edges and weights, up to max_edges, and return its number of lines, with those
+// at the multiples of stride, and the last one. The weights printed are parsed back to the same values in the output
+static int64_t parse_edge_list(const char* path, packed_edge* edges, void* weights, int64_t max_edges, int64_t stride, vector<pair<int64_t, string>>* samples, string* last_line){
+    fstream in(path, ios_base::in);
+    if(!in.good()){
+        cerr << "Cannot open the file " << path << endl;
+        abort();
+    }
+    int64_t num_lines = 0;
+    string line;
+    while(getline(in, line)){
+        if(num_lines == max_edges){
+            cerr << "ERROR: The edge list " << path << " has more than the " << max_edges << " edges expected" << endl;
+            abort();
+        }
+        const char* p = line.c_str();
+        char* end = nullptr;
+        long long src = strtoll(p, &end, 10);
+        long long dst = strtoll(end, &end, 10);
+        if(weights != nullptr){
+            switch(po_weight.type){
+            case WEIGHT_INT32: static_cast<int32_t*>(weights)[num_lines] = strtol(end, &end, 10); break;
+            case WEIGHT_UINT16: static_cast<uint16_t*>(weights)[num_lines] = strtoul(end, &end, 10); break;
+            case WEIGHT_UINT8: static_cast<uint8_t*>(weights)[num_lines] = strtoul(end, &end, 10); break;
+            default: static_cast<float*>(weights)[num_lines] = strtof(end, &end); break;
+            }
+        }
+        if(end == p || *end != '\0'){
+            cerr << "ERROR: Invalid edge in " << path << " at the line " << num_lines +1 << ": `" << line << "'" << endl;
+            abort();
+        }
+        write_edge(edges + num_lines, src, dst);
+        if(num_lines % stride == 0){ samples->emplace_back(num_lines, line); }
+        num_lines++;
+        last_line->swap(line);
+    }
+    return num_lines;
+}
+
+// Whether the two paths name the same file, through links too. False if either does not exist
+static bool same_file(const char* path1, const char* path2){
+    struct stat stat1, stat2;
+    if(stat(path1, &stat1) != 0 || stat(path2, &stat2) != 0) return false;
+    return stat1.st_dev == stat2.st_dev && stat1.st_ino == stat2.st_ino;
+}
+
+// --extend-from with a plain output: copy the edge list into the output, unless it is the output itself, to append
+// the other edges to it. Returns its number of edges, after checking them against the graph
+static int64_t copy_prefix(const KroneckerParameters& params){
+    // read and check the edge list first, the output is only opened, and emptied, for an edge list of this graph
+    cout << "[extend_from] Reading the edges of `" << po_path_extend_from << "' ..." << endl;
+    vector<pair<int64_t, string>> samples; string last_line;
+    int64_t num_lines = copy_edge_list(po_path_extend_from, nullptr, prefix_sample_stride(), &samples, &last_line);
+    check_prefix(params, num_lines, samples, last_line);
+
+    if(!same_file(po_path_extend_from, po_path_output)){
+        cout << "[extend_from] Copying the edges of `" << po_path_extend_from << "' ..." << endl;
+        fstream out(po_path_output, ios_base::out | ios_base::binary);
+        if(!out.good()){
+            cerr << "Cannot open the file " << po_path_output << endl;
+            abort();
+        }
+        if(copy_edge_list(po_path_extend_from, &out, numeric_limits<int64_t>::max(), &samples, &last_line) != num_lines){
+            cerr << "ERROR: The edge list " << po_path_extend_from << " changed while it was copied" << endl;
+            abort();
+        }
+    }
+    return num_lines;
+}
+
+// --extend-from with a METIS output, or with the in-edges: read the edge list into edges and weights, arrays for the
+// edges of the whole graph, and return its number of edges, after checking them against the graph
+static int64_t load_prefix(const KroneckerParameters& params, packed_edge* edges, void* weights){
+    cout << "[extend_from] Loading the edges of `" << po_path_extend_from << "' ..." << endl;
+    vector<pair<int64_t, string>> samples; string last_line;
+    int64_t num_lines = parse_edge_list(po_path_extend_from, edges, weights, po_num_edges, prefix_sample_stride(), &samples, &last_line);
+    check_prefix(params, num_lines, samples, last_line);
+    return num_lines;
+}
+
+// The names of the weight types, as in --weight-type
+static const char* weight_type_name(weight_type type){
+    switch(type){
+    case WEIGHT_INT32: return "int32";
+    case WEIGHT_UINT16: return "uint16";
+    case WEIGHT_UINT8: return "uint8";
+    default: return "float";
+    }
+}
+
+// The manifest of a shard, <output>.manifest: the file and the slice of the edges of the shard, then the settings of
+// the graph, one `key value' per line, which --merge requires to be the same in all the shards
+static void save_manifest(int64_t first_edge, int64_t end_edge, int64_t num_edges){
+    string path = string(po_path_output) + ".manifest";
+    fstream f(path, ios_base::out);
+    if(!f.good()) {
+        cerr << "Cannot open the file " << path << endl;
+        abort();
+    }
+    const char* file = strrchr(po_path_output, '/'); // relative to the manifest
+    f << setprecision(17);
+    f << "# shard of a graph of krongen, see --merge\n";
+    f << "file " << (file != nullptr ? file +1 : po_path_output) << "\n";
+    f << "first_edge " << first_edge << "\n";
+    f << "end_edge " << end_edge << "\n";
+    f << "num_edges " << num_edges << "\n"; // kept by the filter
+    f << "model " << po_engine->name << "\n";
+    f << "scale " << po_scale << "\n";
+    f << "vertices " << po_num_vertices << "\n";
+    f << "edges " << po_num_edges << "\n";
+    f << "rng " << (po_rng == RandomGenerator::PHILOX ? "philox" : "mrg") << "\n";
+    f << "initiator ";
+    if(po_initiator_matrix.empty()){
+        f << po_initiator[0] << "," << po_initiator[1] << "," << po_initiator[2] << "," << po_initiator[3] << "\n";
+    } else {
+        for(size_t i = 0; i < po_initiator_matrix.size(); i++){ f << (i > 0 ? "," : "") << po_initiator_matrix[i]; }
+        f << "\n";
+    }
+    f << "noise " << po_noise << "\n";
+    f << "fast_sampler " << po_fast_sampler << "\n";
+    f << "source_ordered " << po_source_ordered << "\n";
+    f << "scramble " << po_scramble << "\n";
+    f << "directed " << po_directed << "\n";
+    f << "degrees " << (po_path_degrees != nullptr ? po_path_degrees : "-") << " " << po_degree_exponent << "\n";
+    f << "weights " << (po_weights ? weight_type_name(po_weight.type) : "none") << " " << (int) po_weight.distribution << " " << po_weight.min << " " << po_weight.max << " " << po_weight.mean << " " << po_weight.mu << " " << po_weight.sigma << "\n";
+    f << "filter " << po_filter.self_loops << " " << po_filter.partition << "/" << po_filter.num_partitions << " " << po_filter.source_begin << "," << po_filter.source_end << "\n";
+    if(!f.good()){
+        cerr << "Error writing in " << path << endl;
+        abort();
+    }
+}
+
+// The entries `key value' of a manifest
+static map<string, string> read_manifest(const char* path){
+    fstream f(path, ios_base::in);
+    if(!f.good()){
+        cerr << "ERROR: Cannot open the manifest " << path << endl;
+        abort();
+    }
+    map<string, string> entries;
+    string line;
+    while(getline(f, line)){
+        if(line.empty() || line[0] == '#') continue;
+        size_t space = line.find(' ');
+        entries[line.substr(0, space)] = (space == string::npos) ? "" : line.substr(space +1);
+    }
+    for(const char* key : { "file", "first_edge", "end_edge", "num_edges", "edges", "directed", "source_ordered", "weights" }){
+        if(entries.count(key) == 0){
+            cerr << "ERROR: The manifest " << path << " has no entry `" << key << "'" << endl;
+            abort();
+        }
+    }
+    return entries;
+}
+
+// --merge: join the shards of the manifests into the output, in the order of their edges
+static void merge_shards(){
+    struct Shard {
+        string m_path; // the edge list
+        int64_t m_first_edge; // the slice [m_first_edge, m_end_edge) of the edges of the graph
+        int64_t m_end_edge;
+        int64_t m_num_edges; // the edges in the list, kept by the filter
+    };
+    vector<Shard> shards;
+    map<string, string> graph; // the settings of the graph, the same in all the manifests
+    for(const char* path : po_path_manifests){
+        map<string, string> entries = read_manifest(path);
+        Shard shard;
+        const char* slash = strrchr(path, '/');
+        shard.m_path = (entries["file"][0] == '/' || slash == nullptr) ? entries["file"] : string(path, slash +1) + entries["file"];
+        shard.m_first_edge = strtoll(entries["first_edge"].c_str(), nullptr, 10);
+        shard.m_end_edge = strtoll(entries["end_edge"].c_str(), nullptr, 10);
+        shard.m_num_edges = strtoll(entries["num_edges"].c_str(), nullptr, 10);
+        shards.push_back(shard);
+        for(const char* key : { "file", "first_edge", "end_edge", "num_edges" }){ entries.erase(key); }
+        if(graph.empty()){
+            graph = entries;
+        } else if(entries != graph){
+            cerr << "ERROR: The shard " << path << " is not of the same graph of " << po_path_manifests[0] << endl;
+            abort();
+        }
+    }
+
+    // the shards must cover the edges of the graph, once
+    sort(shards.begin(), shards.end(), [](const Shard& a, const Shard& b){ // the empty shards first, at the same edge
+        return a.m_first_edge < b.m_first_edge || (a.m_first_edge == b.m_first_edge && a.m_end_edge < b.m_end_edge);
+    });
+    const int64_t num_graph_edges = strtoll(graph["edges"].c_str(), nullptr, 10);
+    int64_t next_edge = 0, num_edges = 0;
+    for(const Shard& shard : shards){
+        if(shard.m_first_edge != next_edge){
+            cerr << "ERROR: The shards " << (shard.m_first_edge > next_edge ? "miss" : "overlap on") << " the edges from " << min(shard.m_first_edge, next_edge) << ", at " << shard.m_path << endl;
+            abort();
+        }
+        next_edge = shard.m_end_edge;
+        num_edges += shard.m_num_edges;
+    }
+    if(next_edge != num_graph_edges){
+        cerr << "ERROR: The shards miss the edges [" << next_edge << ", " << num_graph_edges << ") of the graph" << endl;
+        abort();
+    }
+
+    // the settings of the output
+    po_directed = graph["directed"] == "1";
+    po_source_ordered = graph["source_ordered"] == "1";
+    string weights_type = graph["weights"].substr(0, graph["weights"].find(' '));
+    po_weights = weights_type != "none";
+    for(weight_type type : { WEIGHT_FLOAT, WEIGHT_INT32, WEIGHT_UINT16, WEIGHT_UINT8 }){
+        if(weights_type == weight_type_name(type)){ po_weight.type = type; }
+    }
+    if(po_in_edges && !po_directed){
+        cerr << "ERROR: The option --in-edges requires the shards of a directed graph" << endl;
+        abort();
+    }
+    cout << "Merging " << shards.size() << " shards, " << num_edges << " edges, into `" << po_path_output << "' ..." << endl;
+
+    // only the number of lines of the shards is checked, not their edges
+    const int64_t no_samples = numeric_limits<int64_t>::max();
+    vector<pair<int64_t, string>> samples; string last_line;
+    if(po_output_type == OutputGraphType::PLAIN && !po_in_edges){ // concatenate the edge lists
+        fstream out(po_path_output, ios_base::out | ios_base::binary);
+        if(!out.good()){
+            cerr << "Cannot open the file " << po_path_output << endl;
+            abort();
+        }
+        for(const Shard& shard : shards){
+            if(copy_edge_list(shard.m_path.c_str(), &out, no_samples, &samples, &last_line) != shard.m_num_edges){
+                cerr << "ERROR: The edge list " << shard.m_path << " does not have the " << shard.m_num_edges << " edges of its manifest" << endl;
+                abort();
+            }
+        }
+    } else { // the whole graph, for the CSR
+        packed_edge* edges = (packed_edge*) xmalloc(num_edges * sizeof(packed_edge));
+        void* weights = po_weights ? xmalloc(num_edges * weight_size(po_weight.type)) : nullptr;
+        int64_t offset = 0;
+        for(const Shard& shard : shards){
+            if(parse_edge_list(shard.m_path.c_str(), edges + offset, weight_at(weights, offset, po_weight.type), shard.m_num_edges, no_samples, &samples, &last_line) != shard.m_num_edges){
+                cerr << "ERROR: The edge list " << shard.m_path << " does not have the " << shard.m_num_edges << " edges of its manifest" << endl;
+                abort();
+            }
+            offset += shard.m_num_edges;
+        }
+        save_graph(num_edges, edges, weights);
+        free(weights); weights = nullptr;
+        free(edges); edges = nullptr;
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "kronecker.hpp"
+#include "kernel_dispatch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+KroneckerGraph::KroneckerGraph(const KroneckerParameters& params) : m_generator(kernel_set().make_kronecker_graph(params)) {
+    const uint64_t num_vertices = m_generator->num_vertices();
+    if(params.edgefactor == 0 || params.edgefactor > static_cast<uint64_t>(INT64_MAX) / num_vertices) { throw std::invalid_argument("[KroneckerGraph] invalid edge factor"); }
+    m_num_edges = params.edgefactor * num_vertices;
+}
+
+packed_edge KroneckerGraph::edge(int64_t index, void* weight) const {
+    if(index < 0 || index >= m_num_edges) { throw std::invalid_argument("[KroneckerGraph::edge] the index must be in [0, num_edges)"); }
+    packed_edge result;
+    m_generator->edge(index, &result, weight);
+    return result;
+}
+
+int64_t KroneckerGraph::edges(int64_t first, int64_t count, packed_edge* edges, void* weights) const {
+    if(first < 0 || count < 0 || count > m_num_edges - first) { throw std::invalid_argument("[KroneckerGraph::edges] the edges must be in [0, num_edges)"); }
+    if(edges == nullptr) { throw std::invalid_argument("[KroneckerGraph::edges] edges is nullptr"); }
+    return m_generator->edges(first, first + count, edges, weights);
+}
+
+// The parameters of make_graph
+static KroneckerParameters graph500_parameters(int scale, uint64_t edgefactor, uint64_t userseed1, uint64_t userseed2){
+    KroneckerParameters params;
+    params.scale = scale;
+    params.edgefactor = edgefactor;
+    params.userseed1 = userseed1;
+    params.userseed2 = userseed2;
+    return params;
+}
+
+EdgeStream::EdgeStream(const KroneckerParameters& params, int64_t block_size, bool weighted) : m_graph(params), m_block_size(block_size), m_weight_size(weighted ? weight_size(params.weight.type) : 0) {
+    if(block_size <= 0) { throw std::invalid_argument("[EdgeStream] the block size must be positive"); }
+}
+
+EdgeStream::EdgeStream(int scale, uint64_t edgefactor, uint64_t userseed1, uint64_t userseed2, int64_t block_size) : EdgeStream(graph500_parameters(scale, edgefactor, userseed1, userseed2), block_size) {
+
+}
+
+EdgeStream::Iterator EdgeStream::begin(){
+    if(num_blocks() > 0){ generate_block(0, m_block); }
+    return Iterator{ this, 0 };
+}
+
+EdgeStream::Iterator EdgeStream::end(){
+    return Iterator{ this, num_blocks() };
+}
+
+EdgeStream::Iterator& EdgeStream::Iterator::operator++(){
+    m_index++;
+    if(m_index < m_stream->num_blocks()){ m_stream->generate_block(m_index, m_stream->m_block); }
+    return *this;
+}
+
+void EdgeStream::generate_block(int64_t index, Block& block) const {
+    if(index < 0 || index >= num_blocks()) { throw std::invalid_argument("[EdgeStream::generate_block] the index must be in [0, num_blocks)"); }
+    const int64_t first_edge = index * m_block_size;
+    const int64_t count = min(m_block_size, num_edges() - first_edge);
+
+    // the arrays of the block, unless they are large enough
+    if(block.m_edges == nullptr || block.m_capacity < count){
+        block.m_edges.reset(new packed_edge[count]);
+        block.m_capacity = count;
+    }
+    if(m_weight_size == 0){
+        block.m_weights.reset();
+        block.m_weights_capacity = 0;
+    } else if(block.m_weights == nullptr || block.m_weights_capacity < count * m_weight_size){
+        block.m_weights.reset(new char[count * m_weight_size]);
+        block.m_weights_capacity = count * m_weight_size;
+    }
+
+    block.m_first_edge = first_edge;
+    block.m_end_edge = first_edge + count;
+    block.m_size = m_graph.edges(first_edge, count, block.m_edges.get(), block.m_weights.get());
+}
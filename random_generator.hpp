@@ -0,0 +1,210 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "kernel_dispatch.hpp" // KERNEL_NAMESPACE
+#include "third-party/graph500_generator/splittable_mrg.h"
+#include "third-party/graph500_generator/utils.h" // make_mrg_seed
+
+namespace KERNEL_NAMESPACE {
+
+/**
+ * RNG policies for the edge generator. A policy gives each edge its own stream of random numbers:
+ * - Stream edge(e): the stream for the edge e, in random access
+ * - void next_edge(Stream& s): move the stream of the edge e to the stream of the edge e +1
+ * - Stream substream(domain, id): the stream id of the family domain > 0, independent of the streams of the edges, for
+ *   the generators that do not draw the edges one at a time
+ * - Stream::next_uint(): the next random value in [0, range)
+ * - Stream::next_float(): the next random value in [0, 1)
+ * - to_float(value): the value of next_float() for the draw that next_uint() returned as value
+ */
+
+/**
+ * The multiple recursive generator of the Graph500 specification, as in generate_kronecker_range
+ */
+class MrgRng {
+    mrg_state m_seed;
+
+public:
+    // Values are in [0, 2^31 -1)
+    static constexpr uint32_t range = 0x7FFFFFFF;
+
+    // As mrg_get_float_orig
+    static float to_float(uint32_t value) { return static_cast<float>(static_cast<float>(value) * .000000000465661287524579692); }
+
+    class Stream {
+        friend class MrgRng;
+        mrg_state m_state;
+
+    public:
+        uint32_t next_uint() { return mrg_get_uint_orig(&m_state); }
+        float next_float() { return mrg_get_float_orig(&m_state); }
+    };
+
+    MrgRng(uint64_t userseed1, uint64_t userseed2) {
+        uint_fast32_t seed[5];
+        make_mrg_seed(userseed1, userseed2, seed);
+        mrg_seed(&m_seed, seed);
+    }
+
+    Stream edge(uint64_t edge_id) const {
+        Stream stream;
+        stream.m_state = m_seed;
+        mrg_skip(&stream.m_state, 0, edge_id, 0);
+        return stream;
+    }
+
+    void next_edge(Stream& stream) const {
+        mrg_skip(&stream.m_state, 0, 1, 0);
+    }
+
+    // The streams of the edges are 2^64 values apart, the families of substreams 2^128 values apart
+    Stream substream(uint32_t domain, uint64_t id) const {
+        Stream stream;
+        stream.m_state = m_seed;
+        mrg_skip(&stream.m_state, domain, id, 0);
+        return stream;
+    }
+};
+
+/**
+ * Counter-based generator Philox4x32-10, from J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw,
+ * "Parallel random numbers: as easy as 1, 2, 3", SC 2011.
+ * The i-th random value of the edge e is a pure function of (seed, e, i). There is no state to carry from one value
+ * to the next, nor a jump to compute to reach an edge, and independent edges can be evaluated in any order.
+ * The stream is not the same of the Graph500 specification.
+ */
+class PhiloxRng {
+    uint32_t m_key[2];
+
+    static void mulhilo(uint32_t a, uint32_t b, uint32_t* hi, uint32_t* lo){
+        uint64_t product = static_cast<uint64_t>(a) * b;
+        *hi = static_cast<uint32_t>(product >> 32);
+        *lo = static_cast<uint32_t>(product);
+    }
+
+public:
+    // Encrypt the counter ctr with the given key, 10 rounds. Public for the known-answer tests of make check
+    static void philox4x32(const uint32_t key_in[2], uint32_t ctr[4]){
+        uint32_t key[2] = { key_in[0], key_in[1] };
+        for(int round = 0; round < 10; round++){
+            uint32_t hi0, lo0, hi1, lo1;
+            mulhilo(UINT32_C(0xD2511F53), ctr[0], &hi0, &lo0);
+            mulhilo(UINT32_C(0xCD9E8D57), ctr[2], &hi1, &lo1);
+            uint32_t c0 = hi1 ^ ctr[1] ^ key[0];
+            uint32_t c1 = lo1;
+            uint32_t c2 = hi0 ^ ctr[3] ^ key[1];
+            uint32_t c3 = lo0;
+            ctr[0] = c0; ctr[1] = c1; ctr[2] = c2; ctr[3] = c3;
+            key[0] += UINT32_C(0x9E3779B9);
+            key[1] += UINT32_C(0xBB67AE85);
+        }
+    }
+
+    // Values are in [0, 2^31)
+    static constexpr uint32_t range = 0x80000000;
+
+    // The 24 high bits of the word, as next_float()
+    static float to_float(uint32_t value) { return static_cast<float>(value >> 7) * (1.0f / 16777216.0f); /* 2^-24 */ }
+
+    class Stream {
+        friend class PhiloxRng;
+        uint32_t m_key[2];
+        uint64_t m_edge_id; // first two words of the counter
+        uint32_t m_block; // third word of the counter, the index of the next four values to generate
+        uint32_t m_domain; // fourth word of the counter, 0 for the streams of the edges
+        uint32_t m_buffer[4];
+        int m_position; // next value in m_buffer to return
+
+        uint32_t next_word(){
+            if(m_position == 4){
+                m_buffer[0] = static_cast<uint32_t>(m_edge_id);
+                m_buffer[1] = static_cast<uint32_t>(m_edge_id >> 32);
+                m_buffer[2] = m_block++;
+                m_buffer[3] = m_domain;
+                philox4x32(m_key, m_buffer);
+                m_position = 0;
+            }
+            return m_buffer[m_position++];
+        }
+
+    public:
+        uint32_t next_uint() { return next_word() >> 1; }
+        float next_float() { return static_cast<float>(next_word() >> 8) * (1.0f / 16777216.0f); /* 2^-24 */ }
+    };
+
+    PhiloxRng(uint64_t userseed1, uint64_t userseed2) {
+        // fold the two user seeds into the 64-bit key
+        uint64_t key = userseed1 * UINT64_C(0x9E3779B97F4A7C15) ^ userseed2;
+        m_key[0] = static_cast<uint32_t>(key);
+        m_key[1] = static_cast<uint32_t>(key >> 32);
+    }
+
+    Stream edge(uint64_t edge_id) const {
+        Stream stream;
+        stream.m_key[0] = m_key[0];
+        stream.m_key[1] = m_key[1];
+        stream.m_edge_id = edge_id;
+        stream.m_block = 0;
+        stream.m_domain = 0;
+        stream.m_position = 4; // empty
+        return stream;
+    }
+
+    void next_edge(Stream& stream) const {
+        stream = edge(stream.m_edge_id +1);
+    }
+
+    Stream substream(uint32_t domain, uint64_t id) const {
+        Stream stream = edge(id);
+        stream.m_domain = domain;
+        return stream;
+    }
+
+    // Streams computed together by next_uint_lanes, one per 64-bit lane of a GCC/Clang vector
+    static constexpr int lanes = 8;
+    typedef uint64_t lanes_t __attribute__((vector_size(lanes * sizeof(uint64_t))));
+
+    // The values [4 * block, 4 * block +4) of the streams for the edges first_edge_id, ..., first_edge_id + lanes -1,
+    // that is, the output of next_uint(). The 32-bit words are kept in 64-bit lanes for the widening multiplications
+    void next_uint_lanes(uint64_t first_edge_id, uint32_t block, lanes_t out[4]) const {
+        lanes_t c0, c1, c2 = {0}, c3 = {0};
+        for(int lane = 0; lane < lanes; lane++){
+            c0[lane] = static_cast<uint32_t>(first_edge_id + lane);
+            c1[lane] = static_cast<uint32_t>((first_edge_id + lane) >> 32);
+        }
+        c2 += block;
+        uint32_t key0 = m_key[0], key1 = m_key[1];
+        for(int round = 0; round < 10; round++){
+            lanes_t p0 = c0 * UINT64_C(0xD2511F53);
+            lanes_t p1 = c2 * UINT64_C(0xCD9E8D57);
+            c0 = (p1 >> 32) ^ c1 ^ key0;
+            c1 = p1 & 0xFFFFFFFF;
+            c2 = (p0 >> 32) ^ c3 ^ key1;
+            c3 = p0 & 0xFFFFFFFF;
+            key0 += UINT32_C(0x9E3779B9);
+            key1 += UINT32_C(0xBB67AE85);
+        }
+        out[0] = c0 >> 1;
+        out[1] = c1 >> 1;
+        out[2] = c2 >> 1;
+        out[3] = c3 >> 1;
+    }
+};
+
+} // namespace KERNEL_NAMESPACE
@@ -0,0 +1,196 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Check of `make check': the edge filters (--no-self-loops, --source-range, --part) of every engine.
+ *
+ * For each engine and each filter, the edges of the filtered generator must be those of the unfiltered one kept by
+ * the filter, with their weights, in the same order: the filter is applied here on the whole edge list, and compared
+ * with the edges the engine compacts block by block and then moves together across the chunks of the threads. The
+ * cases run with one and three threads, on the whole graph and on a range that does not start at a block boundary,
+ * and they cover the Graph500 kernel, the generic and the batched kernels, the source-ordered rows, the generalised
+ * engine and the engines of graph_engine.hpp.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "third-party/graph500_generator/graph_generator.h"
+#include "graph_engine.hpp"
+#include "kronecker.hpp"
+
+using namespace std;
+
+typedef int64_t (*GenerateFunction)(const KroneckerParameters& params, int64_t start_edge, int64_t end_edge, packed_edge* edges, void* weights);
+
+struct Engine {
+    const char* name;
+    KroneckerParameters params;
+    GenerateFunction generate;
+};
+
+struct Filter {
+    const char* name;
+    EdgeFilter filter;
+};
+
+static int failures = 0;
+
+static void set_threads(int num_threads){
+#if defined(_OPENMP)
+    omp_set_num_threads(num_threads);
+#else
+    (void) num_threads;
+#endif
+}
+
+// The reference of the filter, as documented in EdgeFilter
+static bool keep(const EdgeFilter& filter, const packed_edge& edge){
+    const int64_t source = get_v0_from_edge(&edge);
+    const int64_t target = get_v1_from_edge(&edge);
+    return (filter.self_loops || source != target) && source >= filter.source_begin && source < filter.source_end &&
+            vertex_partition(source, filter.num_partitions) == filter.partition;
+}
+
+// Whether the filtered generator returns the edges of the range kept by the filter, in order, with their weights
+static bool check_range(const Engine& engine, const EdgeFilter& filter, int64_t start_edge, int64_t end_edge){
+    const int64_t count = end_edge - start_edge;
+    vector<packed_edge> all_edges(count);
+    vector<float> all_weights(count);
+    if(engine.generate(engine.params, start_edge, end_edge, all_edges.data(), all_weights.data()) != count) return false;
+    vector<packed_edge> expected_edges;
+    vector<float> expected_weights;
+    for(int64_t i = 0; i < count; i++){
+        if(keep(filter, all_edges[i])){
+            expected_edges.push_back(all_edges[i]);
+            expected_weights.push_back(all_weights[i]);
+        }
+    }
+
+    KroneckerParameters params = engine.params;
+    params.filter = filter;
+    vector<packed_edge> edges(count);
+    vector<float> weights(count);
+    const int64_t num_kept = engine.generate(params, start_edge, end_edge, edges.data(), weights.data());
+    if(num_kept != static_cast<int64_t>(expected_edges.size())) return false;
+    for(int64_t i = 0; i < num_kept; i++){
+        if(get_v0_from_edge(&edges[i]) != get_v0_from_edge(&expected_edges[i]) || get_v1_from_edge(&edges[i]) != get_v1_from_edge(&expected_edges[i])) return false;
+    }
+    return memcmp(weights.data(), expected_weights.data(), num_kept * sizeof(float)) == 0;
+}
+
+static void check_engine(const Engine& engine, const Filter filters[], int num_filters){
+    const int64_t num_vertices = engine.params.num_vertices != 0 ? engine.params.num_vertices : INT64_C(1) << engine.params.scale;
+    const int64_t num_edges = engine.params.edgefactor * num_vertices;
+    for(int i = 0; i < num_filters; i++){
+        EdgeFilter filter = filters[i].filter;
+        if(filter.source_end < INT64_MAX){ // the ranges are in fractions of the vertices, as 1/4 -> 1/2
+            filter.source_begin = num_vertices * filter.source_begin / 4;
+            filter.source_end = num_vertices * filter.source_end / 4;
+        }
+        bool passed = true;
+        for(int num_threads : { 1, 3 }){
+            set_threads(num_threads);
+            passed &= check_range(engine, filter, 0, num_edges);
+            passed &= check_range(engine, filter, num_edges / 3 +1, num_edges - 5);
+        }
+        printf("%-30s %-40s %s\n", engine.name, filters[i].name, passed ? "ok" : "FAILED");
+        if(!passed) failures++;
+    }
+}
+
+int main(){
+    KroneckerParameters graph500;
+    graph500.scale = 11;
+
+    KroneckerParameters unscrambled = graph500;
+    unscrambled.scramble = false;
+    KroneckerParameters noise = graph500;
+    noise.noise = 0.1;
+    noise.directed = true;
+    KroneckerParameters multilevel = graph500;
+    multilevel.multilevel_sampler = true;
+    KroneckerParameters philox = graph500;
+    philox.rng = RandomGenerator::PHILOX;
+    KroneckerParameters source_ordered = graph500;
+    source_ordered.source_ordered = true;
+    KroneckerParameters source_ordered_philox = source_ordered;
+    source_ordered_philox.rng = RandomGenerator::PHILOX;
+    KroneckerParameters generalised = graph500;
+    generalised.scale = 7;
+    generalised.initiator_matrix = { 0.4, 0.2, 0.1, 0.1, 0.05, 0.05, 0.05, 0.02, 0.03 };
+    generalised.num_vertices = 2000;
+    KroneckerParameters philox_small = graph500;
+    philox_small.rng = RandomGenerator::PHILOX;
+    philox_small.scale = 4; // with many self-loops
+
+    const Engine engines[] = {
+        { "graph500", graph500, generate_kronecker },
+        { "graph500, unscrambled", unscrambled, generate_kronecker },
+        { "noise 0.1, directed", noise, generate_kronecker },
+        { "multilevel sampler", multilevel, generate_kronecker },
+        { "philox", philox, generate_kronecker },
+        { "philox, scale 4", philox_small, generate_kronecker },
+        { "source-ordered", source_ordered, generate_kronecker },
+        { "source-ordered, philox", source_ordered_philox, generate_kronecker },
+        { "3 x 3 initiator, 2000 vertices", generalised, generate_kronecker },
+        { "erdos-renyi", graph500, generate_erdos_renyi },
+        { "erdos-renyi, philox", philox, generate_erdos_renyi },
+        { "chung-lu", graph500, generate_chung_lu },
+    };
+
+    // filter.source_begin and filter.source_end in quarters of the vertices, see check_engine
+    EdgeFilter no_self_loops;
+    no_self_loops.self_loops = false;
+    EdgeFilter source_range;
+    source_range.source_begin = 1; source_range.source_end = 2;
+    EdgeFilter empty_range;
+    empty_range.source_begin = 2; empty_range.source_end = 2;
+    EdgeFilter partition;
+    partition.num_partitions = 5; partition.partition = 2;
+    EdgeFilter all;
+    all.self_loops = false;
+    all.source_begin = 0; all.source_end = 3;
+    all.num_partitions = 3; all.partition = 1;
+    const Filter filters[] = {
+        { "no self-loops", no_self_loops },
+        { "sources in [n/4, n/2)", source_range },
+        { "sources in [n/2, n/2)", empty_range },
+        { "partition 2/5", partition },
+        { "all, partition 1/3", all },
+    };
+
+    try {
+        for(const Engine& engine : engines){
+            check_engine(engine, filters, sizeof(filters) / sizeof(filters[0]));
+        }
+    } catch(const exception& e){
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if(failures > 0){
+        fprintf(stderr, "ERROR: %d check(s) of the edge filters failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
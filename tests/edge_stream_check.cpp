@@ -0,0 +1,179 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Check of `make check': the blocks of EdgeStream are the ranges of generate_kronecker.
+ *
+ * For each case and block size, including the sizes that do not divide the number of edges and those larger than the
+ * graph, the stream is traversed with its iterators: the block i must be the range [i * block_size, (i +1) *
+ * block_size) of the edges, cut at the end, with the edges and the weights of generate_kronecker over that range, and
+ * the blocks together the edges of the whole graph. The same blocks must come from generate_block, concurrently from
+ * the threads, from a second traversal and from a traversal that moves every other block away. The cases cover the
+ * weighted and unweighted streams, the filters, whose blocks hold the edges kept of their range, the other types of
+ * the weights and the Graph500 constructor.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "third-party/graph500_generator/graph_generator.h"
+#include "kronecker.hpp"
+
+using namespace std;
+
+static int failures = 0;
+
+static void report(const char* name, bool passed){
+    printf("%-72s %s\n", name, passed ? "ok" : "FAILED");
+    if(!passed) failures++;
+}
+
+// The edges, and the weights unless weighted is false, of generate_kronecker over a range
+struct Range {
+    vector<packed_edge> m_edges;
+    vector<char> m_weights;
+
+    Range(const KroneckerParameters& params, int64_t first_edge, int64_t end_edge, bool weighted) : m_edges(end_edge - first_edge), m_weights(weighted ? (end_edge - first_edge) * weight_size(params.weight.type) : 0) {
+        const int64_t num_kept = generate_kronecker(params, first_edge, end_edge, m_edges.data(), weighted ? m_weights.data() : nullptr);
+        m_edges.resize(num_kept);
+        m_weights.resize(weighted ? num_kept * weight_size(params.weight.type) : 0);
+    }
+};
+
+// Whether the block is the block index of the stream, with the edges and the weights of the range
+static bool same_block(const KroneckerParameters& params, const EdgeStream& stream, int64_t index, const EdgeStream::Block& block, bool weighted){
+    const int64_t first_edge = index * stream.block_size();
+    const int64_t end_edge = min(first_edge + stream.block_size(), stream.num_edges());
+    if(block.first_edge() != first_edge || block.end_edge() != end_edge) return false;
+    Range expected { params, first_edge, end_edge, weighted };
+    if(block.size() != static_cast<int64_t>(expected.m_edges.size())) return false;
+    if(!weighted) { if(block.weights() != nullptr) return false; }
+    else if(memcmp(block.weights(), expected.m_weights.data(), expected.m_weights.size()) != 0) return false;
+    for(int64_t i = 0; i < block.size(); i++){
+        if(get_v0_from_edge(block.edges() + i) != get_v0_from_edge(&expected.m_edges[i]) || get_v1_from_edge(block.edges() + i) != get_v1_from_edge(&expected.m_edges[i])) return false;
+    }
+    return true;
+}
+
+static void check_stream(const char* name, const KroneckerParameters& params, int64_t block_size, bool weighted){
+    EdgeStream stream { params, block_size, weighted };
+    const int64_t num_blocks = stream.num_blocks();
+
+    // the iterators, with the concatenation of the blocks
+    bool iterated = stream.num_edges() == KroneckerGraph(params).num_edges();
+    int64_t index = 0;
+    vector<packed_edge> all_edges;
+    for(EdgeStream::Block& block : stream){
+        iterated &= index < num_blocks && same_block(params, stream, index, block, weighted);
+        all_edges.insert(all_edges.end(), block.begin(), block.end());
+        index++;
+    }
+    iterated &= index == num_blocks;
+    Range whole { params, 0, stream.num_edges(), false };
+    iterated &= all_edges.size() == whole.m_edges.size() && memcmp(all_edges.data(), whole.m_edges.data(), all_edges.size() * sizeof(packed_edge)) == 0;
+
+    // concurrently, with the blocks of the threads
+    bool concurrent = true;
+    #pragma omp parallel for schedule(dynamic) reduction(&&: concurrent)
+    for(int64_t i = 0; i < num_blocks; i++){
+        EdgeStream::Block block;
+        stream.generate_block(i, block);
+        concurrent = concurrent && same_block(params, stream, i, block, weighted);
+    }
+
+    // again, moving every other block away
+    bool moved = true;
+    index = 0;
+    vector<EdgeStream::Block> taken;
+    for(EdgeStream::Block& block : stream){
+        moved &= same_block(params, stream, index, block, weighted);
+        if(index % 2 == 0) taken.push_back(std::move(block));
+        index++;
+    }
+    moved &= index == num_blocks;
+    for(size_t i = 0; i < taken.size(); i++){ moved &= same_block(params, stream, 2 * i, taken[i], weighted); }
+
+    char description[128];
+    snprintf(description, sizeof(description), "%s, blocks of %" PRId64 ", iterators", name, block_size); report(description, iterated);
+    snprintf(description, sizeof(description), "%s, blocks of %" PRId64 ", generate_block", name, block_size); report(description, concurrent);
+    snprintf(description, sizeof(description), "%s, blocks of %" PRId64 ", moved", name, block_size); report(description, moved);
+}
+
+int main(){
+    try {
+        KroneckerParameters graph500;
+        graph500.scale = 10; // 16384 edges
+        KroneckerParameters philox = graph500;
+        philox.rng = RandomGenerator::PHILOX;
+        KroneckerParameters filtered = graph500;
+        filtered.filter.self_loops = false;
+        filtered.filter.num_partitions = 3;
+        filtered.filter.partition = 2;
+        KroneckerParameters source_ordered = graph500;
+        source_ordered.source_ordered = true;
+        source_ordered.filter.source_begin = 100;
+        source_ordered.filter.source_end = 600;
+        KroneckerParameters int32_weights = graph500;
+        int32_weights.weight.type = WEIGHT_INT32;
+        int32_weights.weight.max = 1000;
+        KroneckerParameters generalised = graph500;
+        generalised.scale = 7;
+        generalised.initiator_matrix = { 0.4, 0.2, 0.1, 0.1, 0.05, 0.05, 0.05, 0.02, 0.03 };
+        generalised.num_vertices = 2000;
+
+        for(int64_t block_size : { INT64_C(1000), INT64_C(4096), INT64_C(16384), INT64_C(20000) }){
+            check_stream("graph500", graph500, block_size, true);
+        }
+        check_stream("graph500, unweighted", graph500, 777, false);
+        check_stream("philox", philox, 3000, true);
+        check_stream("philox, unweighted", philox, 1 << 12, false);
+        check_stream("no self-loops, partition 2/3", filtered, 1000, true);
+        check_stream("source-ordered, sources in [100, 600)", source_ordered, 5000, true);
+        check_stream("int32 weights", int32_weights, 999, true);
+        check_stream("3 x 3 initiator, 2000 vertices", generalised, 3333, true);
+
+        // the Graph500 graph, as generate_kronecker with the seeds and the edge factor
+        KroneckerParameters seeds = graph500;
+        seeds.edgefactor = 8;
+        seeds.userseed1 = 12345;
+        seeds.userseed2 = 67890;
+        EdgeStream stream { 10, 8, 12345, 67890, 1500 };
+        bool passed = stream.num_edges() == 8 << 10 && stream.block_size() == 1500;
+        int64_t index = 0;
+        for(EdgeStream::Block& block : stream){ passed &= same_block(seeds, stream, index++, block, true); }
+        report("graph500 constructor, edge factor 8, other seeds", passed && index == stream.num_blocks());
+
+        // the invalid block sizes and indices
+        bool rejected = false;
+        try { EdgeStream invalid { graph500, 0 }; } catch(const invalid_argument&){ rejected = true; }
+        try { EdgeStream::Block block; stream.generate_block(stream.num_blocks(), block); rejected = false; } catch(const invalid_argument&){ }
+        report("invalid block size and index", rejected);
+    } catch(const exception& e){
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if(failures > 0){
+        fprintf(stderr, "ERROR: %d check(s) of EdgeStream failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Check of `make check': the multilevel sampler (--fast-sampler) draws the edges from the same distribution of the
+ * per-level recursion.
+ *
+ * For each case, the edges are generated without scrambling, so that the bits of the vertex ids are the quadrants of
+ * the levels of the recursion, once with the per-level kernel and once with the multilevel sampler, from different
+ * seeds, so that the two samples are independent. The pairs (source, target) restricted to a window of consecutive
+ * levels are counted in the two samples, and compared with the two-sample chi-square statistic:
+ *
+ *   X^2 = sum_i (R_i - S_i)^2 / (R_i + S_i), over the cells with R_i + S_i > 0
+ *
+ * which, for samples of the same size from the same distribution, has a chi-square distribution with cells -1 degrees
+ * of freedom. The check fails when X^2 is more than MAX_DEVIATIONS standard deviations, sqrt(2 df), above its mean df.
+ * The windows are the first levels, the last ones and the levels across the boundary of two tables of the sampler, in
+ * the middle, so they cover the clip-and-flip on the diagonal, carried from a table to the next, and the initiator of
+ * each level with the noise. A last case compares two different initiators, to check that the statistic rejects them.
+ */
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "third-party/graph500_generator/graph_generator.h"
+#include "kronecker.hpp"
+
+using namespace std;
+
+static constexpr int64_t NUM_EDGES = INT64_C(1) << 20; // per sample
+static constexpr int WINDOW_LEVELS = 3; // the levels of a window, 4^3 cells
+static constexpr double MAX_DEVIATIONS = 6.0; // threshold of the statistic, in standard deviations from the mean
+
+struct Case {
+    const char* name;
+    int scale;
+    double initiator[4];
+    double noise;
+    RandomGenerator rng;
+    bool directed;
+};
+
+static KroneckerParameters parameters(const Case& test, bool multilevel_sampler){
+    KroneckerParameters params;
+    params.scale = test.scale;
+    params.userseed1 = multilevel_sampler ? 11 : 2; // independent samples
+    params.userseed2 = multilevel_sampler ? 13 : 3;
+    params.rng = test.rng;
+    params.multilevel_sampler = multilevel_sampler;
+    for(int i = 0; i < 4; i++){ params.initiator[i] = test.initiator[i]; }
+    params.noise = test.noise;
+    params.scramble = false;
+    params.directed = test.directed;
+    return params;
+}
+
+// The frequencies of the pairs (source, target) of the levels [first_level, first_level + num_levels) in the edges
+static vector<int64_t> histogram(const vector<packed_edge>& edges, int scale, int first_level, int num_levels){
+    vector<int64_t> counts(1 << (2 * num_levels), 0);
+    const int shift = scale - first_level - num_levels; // the first level is in the highest bit
+    const int64_t mask = (INT64_C(1) << num_levels) -1;
+    for(const packed_edge& edge : edges){
+        int64_t src = (get_v0_from_edge(&edge) >> shift) & mask;
+        int64_t tgt = (get_v1_from_edge(&edge) >> shift) & mask;
+        counts[(src << num_levels) | tgt]++;
+    }
+    return counts;
+}
+
+// The two-sample chi-square statistic, in standard deviations from its mean
+static double chi_square_deviations(const vector<int64_t>& sample1, const vector<int64_t>& sample2){
+    double statistic = 0;
+    int cells = 0;
+    for(size_t i = 0; i < sample1.size(); i++){
+        const int64_t total = sample1[i] + sample2[i];
+        if(total == 0) continue;
+        const double difference = static_cast<double>(sample1[i] - sample2[i]);
+        statistic += difference * difference / total;
+        cells++;
+    }
+    const double df = max(cells -1, 1);
+    return (statistic - df) / sqrt(2 * df);
+}
+
+// The largest deviation among the windows of the levels, for the edges of the two samples
+static double max_deviation(const Case& test, const vector<packed_edge>& sample1, const vector<packed_edge>& sample2){
+    const int num_levels = min(WINDOW_LEVELS, test.scale);
+    const int windows[] = { 0, max(min(4, test.scale - num_levels) - num_levels / 2, 0), test.scale - num_levels }; // the first, across the first two tables, the last
+    double result = -INFINITY;
+    for(int first_level : windows){
+        const double deviations = chi_square_deviations(histogram(sample1, test.scale, first_level, num_levels), histogram(sample2, test.scale, first_level, num_levels));
+        result = max(result, deviations);
+    }
+    return result;
+}
+
+static vector<packed_edge> generate(const KroneckerParameters& params){
+    vector<packed_edge> edges(NUM_EDGES);
+    generate_kronecker(params, 0, NUM_EDGES, edges.data(), nullptr);
+    return edges;
+}
+
+int main(){
+    const Case cases[] = {
+        { "spec", 10, { 0.57, 0.19, 0.19, 0.05 }, 0, RandomGenerator::MRG, false },
+        { "spec, scale 3", 3, { 0.57, 0.19, 0.19, 0.05 }, 0, RandomGenerator::MRG, false },
+        { "spec, scale 13, philox", 13, { 0.57, 0.19, 0.19, 0.05 }, 0, RandomGenerator::PHILOX, false },
+        { "spec, directed", 9, { 0.57, 0.19, 0.19, 0.05 }, 0, RandomGenerator::MRG, true },
+        { "b != c", 11, { 0.45, 0.30, 0.10, 0.15 }, 0, RandomGenerator::MRG, false },
+        { "b != c, directed, philox", 11, { 0.45, 0.30, 0.10, 0.15 }, 0, RandomGenerator::PHILOX, true },
+        { "uniform", 8, { 0.25, 0.25, 0.25, 0.25 }, 0, RandomGenerator::PHILOX, false },
+        { "noise 0.1", 12, { 0.57, 0.19, 0.19, 0.05 }, 0.1, RandomGenerator::MRG, false },
+        { "noise 0.05, b != c, directed", 14, { 0.50, 0.25, 0.15, 0.10 }, 0.05, RandomGenerator::MRG, true },
+        { "noise 0.1, scale 20, philox", 20, { 0.57, 0.19, 0.19, 0.05 }, 0.1, RandomGenerator::PHILOX, false },
+    };
+
+    int failures = 0;
+    try {
+        for(const Case& test : cases){
+            const double deviations = max_deviation(test, generate(parameters(test, false)), generate(parameters(test, true)));
+            const bool passed = deviations <= MAX_DEVIATIONS;
+            printf("%-40s chi-square: %+7.2f sd %s\n", test.name, deviations, passed ? "ok" : "FAILED");
+            if(!passed) failures++;
+        }
+
+        // control: the statistic tells apart two initiators that differ by 0.01
+        const Case reference = { "control", 10, { 0.57, 0.19, 0.19, 0.05 }, 0, RandomGenerator::MRG, false };
+        Case other = reference; other.initiator[0] = 0.56; other.initiator[3] = 0.06;
+        const double deviations = max_deviation(reference, generate(parameters(reference, false)), generate(parameters(other, true)));
+        const bool rejected = deviations > MAX_DEVIATIONS;
+        printf("%-40s chi-square: %+7.2f sd %s\n", "control, a and d off by 0.01", deviations, rejected ? "ok, rejected" : "FAILED, not rejected");
+        if(!rejected) failures++;
+    } catch(const exception& e){
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if(failures > 0){
+        fprintf(stderr, "ERROR: %d check(s) of the multilevel sampler failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Check of `make check': the Philox backend (--rng philox).
+ *
+ * The block function is checked against the known answers of Philox4x32-10 from Random123 (kat_vectors), the streams
+ * of the edges against the block function and the vector lanes of the batched kernels against the streams. The edges
+ * of generate_kronecker are then checked to be a pure function of the edge index: the same for any range and any number
+ * of threads, the same of KroneckerGraph::edge, which draws a single edge with the scalar kernel, and the same with or
+ * without the weights.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "third-party/graph500_generator/graph_generator.h"
+#include "kronecker.hpp"
+#include "random_generator.hpp"
+
+using namespace std;
+using namespace KERNEL_NAMESPACE; // PhiloxRng, header-only, of the kernel set the check is compiled for
+
+static int failures = 0;
+
+static void report(const char* name, bool passed){
+    printf("%-60s %s\n", name, passed ? "ok" : "FAILED");
+    if(!passed) failures++;
+}
+
+/**** Random number generator ****/
+
+struct KnownAnswer {
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t expected[4];
+};
+
+static void check_known_answers(){
+    const KnownAnswer answers[] = {
+        { { 0, 0 }, { 0, 0, 0, 0 }, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+        { { 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+        { { 0xa4093822, 0x299f31d0 }, { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+    };
+    bool passed = true;
+    for(const KnownAnswer& answer : answers){
+        uint32_t counter[4];
+        memcpy(counter, answer.counter, sizeof(counter));
+        PhiloxRng::philox4x32(answer.key, counter);
+        passed &= memcmp(counter, answer.expected, sizeof(counter)) == 0;
+    }
+    report("philox4x32-10, known answers", passed);
+}
+
+// The i-th value of the stream of an edge is the word i % 4 of the block i / 4 of the counter (edge, i / 4, 0)
+static void check_streams(){
+    const uint64_t userseed1 = 2, userseed2 = 3;
+    const uint64_t key = userseed1 * UINT64_C(0x9E3779B97F4A7C15) ^ userseed2;
+    const uint32_t key_words[2] = { static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32) };
+    PhiloxRng rng { userseed1, userseed2 };
+
+    bool passed = true;
+    for(uint64_t edge_id : { UINT64_C(0), UINT64_C(1), UINT64_C(12345), UINT64_C(0xFFFFFFFF), UINT64_C(0x123456789AB) }){
+        PhiloxRng::Stream stream = rng.edge(edge_id);
+        for(uint32_t block = 0; block < 3; block++){
+            uint32_t counter[4] = { static_cast<uint32_t>(edge_id), static_cast<uint32_t>(edge_id >> 32), block, 0 };
+            PhiloxRng::philox4x32(key_words, counter);
+            for(int i = 0; i < 4; i++){ passed &= stream.next_uint() == counter[i] >> 1; }
+        }
+    }
+    report("streams of the edges, from the counters", passed);
+}
+
+// The lanes of next_uint_lanes are the streams of consecutive edges, also when the low word of the edge id wraps
+static void check_lanes(){
+    PhiloxRng rng { 5, 7 };
+    bool passed = true;
+    for(uint64_t first_edge_id : { UINT64_C(0), UINT64_C(1000), UINT64_C(0xFFFFFFFC), UINT64_C(0x7FFFFFFFFFF0) }){
+        vector<PhiloxRng::Stream> streams;
+        for(int lane = 0; lane < PhiloxRng::lanes; lane++){ streams.push_back(rng.edge(first_edge_id + lane)); }
+        for(uint32_t block = 0; block < 3; block++){
+            PhiloxRng::lanes_t out[4];
+            rng.next_uint_lanes(first_edge_id, block, out);
+            for(int i = 0; i < 4; i++){
+                for(int lane = 0; lane < PhiloxRng::lanes; lane++){
+                    passed &= out[i][lane] == streams[lane].next_uint();
+                }
+            }
+        }
+    }
+    report("vector lanes, from the streams", passed);
+}
+
+/**** Edges ****/
+
+static void set_threads(int num_threads){
+#if defined(_OPENMP)
+    omp_set_num_threads(num_threads);
+#else
+    (void) num_threads;
+#endif
+}
+
+static bool same_edges(const packed_edge* edges1, const packed_edge* edges2, int64_t count){
+    for(int64_t i = 0; i < count; i++){
+        if(get_v0_from_edge(edges1 + i) != get_v0_from_edge(edges2 + i) || get_v1_from_edge(edges1 + i) != get_v1_from_edge(edges2 + i)) return false;
+    }
+    return true;
+}
+
+static void check_edges(const char* name, const KroneckerParameters& params){
+    KroneckerGraph graph { params };
+    const int64_t num_edges = graph.num_edges();
+    vector<packed_edge> edges(num_edges);
+    vector<float> weights(num_edges);
+    set_threads(1);
+    generate_kronecker(params, 0, num_edges, edges.data(), weights.data());
+
+    // the same edges with more threads, and for sub-ranges that do not start at a multiple of the lanes
+    bool threads = true, ranges = true;
+    for(int num_threads : { 2, 3, 4 }){
+        set_threads(num_threads);
+        vector<packed_edge> other(num_edges);
+        vector<float> other_weights(num_edges);
+        generate_kronecker(params, 0, num_edges, other.data(), other_weights.data());
+        threads &= same_edges(edges.data(), other.data(), num_edges) && other_weights == weights;
+
+        for(int64_t start : { INT64_C(1), INT64_C(7), num_edges / 3 +5 }){
+            const int64_t end = min(num_edges, start + num_edges / num_threads +3);
+            generate_kronecker(params, start, end, other.data(), other_weights.data());
+            ranges &= same_edges(edges.data() + start, other.data(), end - start) &&
+                    memcmp(weights.data() + start, other_weights.data(), (end - start) * sizeof(float)) == 0;
+        }
+    }
+    set_threads(1);
+
+    // the scalar kernel of a single edge, on a sample of the edges
+    bool scalar = true;
+    for(int64_t i = 0; i < num_edges && scalar; i += 37){
+        float weight;
+        packed_edge edge = graph.edge(i, &weight);
+        scalar &= same_edges(&edge, edges.data() + i, 1) && weight == weights[i];
+    }
+
+    // the same edges without the weights
+    vector<packed_edge> unweighted(num_edges);
+    generate_kronecker(params, 0, num_edges, unweighted.data(), nullptr);
+    const bool no_weights = same_edges(edges.data(), unweighted.data(), num_edges);
+
+    char description[128];
+    snprintf(description, sizeof(description), "%s, threads", name); report(description, threads);
+    snprintf(description, sizeof(description), "%s, ranges", name); report(description, ranges);
+    snprintf(description, sizeof(description), "%s, single edges", name); report(description, scalar);
+    snprintf(description, sizeof(description), "%s, without weights", name); report(description, no_weights);
+}
+
+int main(){
+    try {
+        check_known_answers();
+        check_streams();
+        check_lanes();
+
+        KroneckerParameters params;
+        params.scale = 12;
+        params.rng = RandomGenerator::PHILOX;
+        check_edges("spec", params);
+
+        KroneckerParameters directed = params;
+        directed.directed = true;
+        directed.noise = 0.1;
+        check_edges("directed, noise 0.1", directed);
+
+        KroneckerParameters multilevel = params;
+        multilevel.multilevel_sampler = true;
+        multilevel.userseed1 = 17;
+        check_edges("multilevel sampler", multilevel);
+
+        KroneckerParameters generalised = params;
+        generalised.scale = 7;
+        generalised.initiator_matrix = { 0.4, 0.2, 0.1, 0.1, 0.05, 0.05, 0.05, 0.02, 0.03 };
+        generalised.num_vertices = 2000;
+        check_edges("3 x 3 initiator, 2000 vertices", generalised);
+    } catch(const exception& e){
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if(failures > 0){
+        fprintf(stderr, "ERROR: %d check(s) of the Philox backend failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Check of `make check': the permutation of the vertex ids (--no-scramble and VertexScrambler).
+ *
+ * VertexScrambler::scramble must be a permutation of [0, num_vertices) and inverse its inverse, for the powers of two,
+ * for the k^scale vertices of a k x k initiator and for the numbers of vertices in between, permuted on the bits of
+ * the next power of two. The small sizes are enumerated in full, the large ones sampled. Without params.scramble both
+ * are the identity. The edges of generate_kronecker must then be those generated without the permutation, with the
+ * vertices mapped by scramble, for each kernel: the vectorised Graph500 kernel, the generic and the batched kernels,
+ * the multilevel sampler and the generalised engine.
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <vector>
+
+#include "third-party/graph500_generator/graph_generator.h"
+#include "kronecker.hpp"
+
+using namespace std;
+
+static constexpr uint64_t MAX_ENUMERATED = UINT64_C(1) << 20; // the sizes enumerated in full, above only sampled
+static constexpr int NUM_SAMPLES = 100000;
+
+static int failures = 0;
+
+static void report(const char* name, bool passed){
+    printf("%-60s %s\n", name, passed ? "ok" : "FAILED");
+    if(!passed) failures++;
+}
+
+// The vertices to check, all of them for the small sizes, a sample drawn with splitmix64 otherwise
+static vector<uint64_t> sample_vertices(uint64_t num_vertices){
+    vector<uint64_t> vertices;
+    if(num_vertices <= MAX_ENUMERATED){
+        for(uint64_t v = 0; v < num_vertices; v++){ vertices.push_back(v); }
+    } else {
+        uint64_t state = num_vertices;
+        vertices.push_back(0);
+        vertices.push_back(num_vertices -1);
+        for(int i = 0; i < NUM_SAMPLES; i++){
+            uint64_t x = (state += UINT64_C(0x9E3779B97F4A7C15));
+            x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+            x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+            vertices.push_back((x ^ (x >> 31)) % num_vertices);
+        }
+    }
+    return vertices;
+}
+
+// scramble maps the vertices into [0, num_vertices), without collisions when enumerated in full, and inverse maps
+// them back, both ways. Without the permutation, both are the identity
+static void check_permutation(const char* name, const KroneckerParameters& params, uint64_t expected_vertices){
+    VertexScrambler scrambler { params };
+    const uint64_t num_vertices = scrambler.num_vertices();
+    bool passed = num_vertices == expected_vertices;
+    const bool enumerated = num_vertices <= MAX_ENUMERATED;
+    vector<bool> seen(enumerated ? num_vertices : 0, false);
+    bool identity = true;
+    for(uint64_t vertex : sample_vertices(num_vertices)){
+        const int64_t id = scrambler.scramble(vertex);
+        if(id < 0 || static_cast<uint64_t>(id) >= num_vertices){ passed = false; break; }
+        if(enumerated){
+            passed &= !seen[id];
+            seen[id] = true;
+        }
+        passed &= scrambler.inverse(id) == static_cast<int64_t>(vertex);
+        passed &= scrambler.scramble(scrambler.inverse(vertex)) == static_cast<int64_t>(vertex);
+        identity &= id == static_cast<int64_t>(vertex);
+    }
+    passed &= params.scramble ? (!identity || num_vertices <= 2) : identity;
+    report(name, passed);
+}
+
+// The edges with the permutation are those without it, mapped by scramble
+static void check_edges(const char* name, const KroneckerParameters& params){
+    KroneckerParameters unscrambled = params;
+    unscrambled.scramble = false;
+    KroneckerGraph graph { params };
+    VertexScrambler scrambler { params };
+    const int64_t num_edges = graph.num_edges();
+    vector<packed_edge> edges(num_edges), original(num_edges);
+    vector<float> weights(num_edges), original_weights(num_edges);
+    generate_kronecker(params, 0, num_edges, edges.data(), weights.data());
+    generate_kronecker(unscrambled, 0, num_edges, original.data(), original_weights.data());
+
+    bool passed = weights == original_weights;
+    for(int64_t i = 0; i < num_edges && passed; i++){
+        passed &= get_v0_from_edge(&edges[i]) == scrambler.scramble(get_v0_from_edge(&original[i])) &&
+                get_v1_from_edge(&edges[i]) == scrambler.scramble(get_v1_from_edge(&original[i]));
+    }
+    report(name, passed);
+}
+
+int main(){
+    try {
+        // the permutations
+        for(int scale : { 1, 2, 5, 10, 16, 20, 21, 33, 40, 57 }){
+            KroneckerParameters params;
+            params.scale = scale;
+            char name[64];
+            snprintf(name, sizeof(name), "permutation, scale %d", scale);
+            check_permutation(name, params, UINT64_C(1) << scale);
+        }
+        for(uint64_t num_vertices : { UINT64_C(2), UINT64_C(3), UINT64_C(1000), UINT64_C(1025), UINT64_C(100000), UINT64_C(3000000), UINT64_C(1000000000000) }){
+            KroneckerParameters params;
+            params.scale = 64 - __builtin_clzll(num_vertices -1); // the smallest with 2^scale >= num_vertices
+            params.num_vertices = num_vertices;
+            char name[64];
+            snprintf(name, sizeof(name), "permutation, %" PRIu64 " vertices", num_vertices);
+            check_permutation(name, params, num_vertices);
+        }
+        KroneckerParameters order3;
+        order3.scale = 5;
+        order3.initiator_matrix = { 0.4, 0.2, 0.1, 0.1, 0.05, 0.05, 0.05, 0.02, 0.03 };
+        check_permutation("permutation, 3 x 3 initiator, 243 vertices", order3, 243);
+        order3.num_vertices = 200;
+        check_permutation("permutation, 3 x 3 initiator, 200 vertices", order3, 200);
+        KroneckerParameters seeds;
+        seeds.scale = 12;
+        seeds.userseed1 = 12345;
+        seeds.userseed2 = 67890;
+        check_permutation("permutation, other seeds", seeds, 4096);
+        for(int scale : { 10, 40 }){
+            KroneckerParameters params;
+            params.scale = scale;
+            params.scramble = false;
+            check_permutation(scale == 10 ? "identity without scramble, scale 10" : "identity without scramble, scale 40", params, UINT64_C(1) << scale);
+        }
+        KroneckerParameters identity = order3;
+        identity.scramble = false;
+        check_permutation("identity without scramble, 200 vertices", identity, 200);
+
+        // the edges
+        KroneckerParameters graph500;
+        graph500.scale = 12;
+        check_edges("edges, graph500", graph500);
+        KroneckerParameters noise = graph500;
+        noise.noise = 0.1;
+        noise.directed = true;
+        check_edges("edges, noise 0.1, directed", noise);
+        KroneckerParameters multilevel = graph500;
+        multilevel.multilevel_sampler = true;
+        check_edges("edges, multilevel sampler", multilevel);
+        KroneckerParameters philox = graph500;
+        philox.rng = RandomGenerator::PHILOX;
+        check_edges("edges, philox", philox);
+        KroneckerParameters exact = graph500;
+        exact.num_vertices = 3000;
+        check_edges("edges, 3000 vertices", exact);
+        order3.scale = 7;
+        order3.num_vertices = 0;
+        check_edges("edges, 3 x 3 initiator", order3);
+        order3.num_vertices = 2000;
+        order3.rng = RandomGenerator::PHILOX;
+        check_edges("edges, 3 x 3 initiator, 2000 vertices, philox", order3);
+    } catch(const exception& e){
+        fprintf(stderr, "ERROR: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    if(failures > 0){
+        fprintf(stderr, "ERROR: %d check(s) of the vertex permutation failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
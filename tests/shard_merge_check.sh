@@ -0,0 +1,132 @@
+#!/bin/sh
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+
+#
+# Check of `make check': the shards of --part and --edge-range, joined with --merge, are the graph of a single run.
+#
+# For each case, the graph is generated once into an edge list and a METIS graph, then in shards, which are merged
+# into both outputs. The outputs must be the same files, byte by byte. The cases cover the even slices of --part, the
+# uneven ranges of --edge-range, with empty and single-edge shards, the filters, the other engines and random number
+# generator, and the in-edges of the directed graphs.
+#
+# Usage: shard_merge_check.sh <krongen>
+#
+
+if [ $# -ne 1 ]; then
+    echo "Usage: $0 <krongen>" >&2
+    exit 1
+fi
+krongen=$1
+workdir=$(mktemp -d "${TMPDIR:-/tmp}/shard_merge_check.XXXXXX") || exit 1
+trap 'rm -rf "${workdir}"' EXIT
+failures=0
+
+# report <name> <status>: the outcome of a case, counted in failures when status is not 0
+report() {
+    if [ "$2" -eq 0 ]; then
+        printf "%-60s ok\n" "$1"
+    else
+        printf "%-60s FAILED\n" "$1"
+        failures=$((failures + 1))
+    fi
+}
+
+# check_part <name> <N> <scale> <options>...: the N slices of --part, merged, against a single run
+check_part() {
+    name=$1 num_parts=$2 scale=$3
+    shift 3
+    rm -rf "${workdir:?}"/*
+    status=0
+    "${krongen}" "$@" "${scale}" "${workdir}/whole.wel" >/dev/null &&
+        "${krongen}" "$@" "${scale}" "${workdir}/whole.graph" >/dev/null || status=1
+    part=0
+    while [ ${part} -lt "${num_parts}" ] && [ ${status} -eq 0 ]; do
+        "${krongen}" "$@" --part "${part}/${num_parts}" "${scale}" "${workdir}/part${part}.wel" >/dev/null || status=1
+        part=$((part + 1))
+    done
+    merge "${name}" ${status}
+}
+
+# check_ranges <name> <scale> <ranges> <options>...: the shards of --edge-range, merged, against a single run
+check_ranges() {
+    name=$1 scale=$2 ranges=$3
+    shift 3
+    rm -rf "${workdir:?}"/*
+    status=0
+    "${krongen}" "$@" "${scale}" "${workdir}/whole.wel" >/dev/null &&
+        "${krongen}" "$@" "${scale}" "${workdir}/whole.graph" >/dev/null || status=1
+    part=0
+    for range in ${ranges}; do
+        "${krongen}" "$@" --edge-range "${range}" "${scale}" "${workdir}/part${part}.wel" >/dev/null || status=1
+        part=$((part + 1))
+    done
+    merge "${name}" ${status}
+}
+
+# merge <name> <status>: merge the shards of the working directory, in reverse order, into both outputs and compare
+merge() {
+    status=$2
+    manifests=$(ls -r "${workdir}"/part*.wel.manifest)
+    if [ ${status} -eq 0 ]; then
+        # shellcheck disable=SC2086 # one argument per manifest
+        "${krongen}" --merge "${workdir}/merged.wel" ${manifests} >/dev/null &&
+            "${krongen}" --merge "${workdir}/merged.graph" ${manifests} >/dev/null &&
+            cmp -s "${workdir}/whole.wel" "${workdir}/merged.wel" &&
+            cmp -s "${workdir}/whole.graph" "${workdir}/merged.graph" || status=1
+    fi
+    report "$1" ${status}
+}
+
+# check_in_edges <name> <N> <scale> <options>...: as check_part, for the out- and in-edges of a directed graph
+check_in_edges() {
+    name=$1 num_parts=$2 scale=$3
+    shift 3
+    rm -rf "${workdir:?}"/*
+    status=0
+    "${krongen}" "$@" --directed --in-edges "${scale}" "${workdir}/whole.graph" >/dev/null || status=1
+    part=0
+    while [ ${part} -lt "${num_parts}" ] && [ ${status} -eq 0 ]; do
+        "${krongen}" "$@" --directed --part "${part}/${num_parts}" "${scale}" "${workdir}/part${part}.wel" >/dev/null || status=1
+        part=$((part + 1))
+    done
+    if [ ${status} -eq 0 ]; then
+        # shellcheck disable=SC2086 # one argument per manifest
+        "${krongen}" --in-edges --merge "${workdir}/merged.graph" "${workdir}"/part*.wel.manifest >/dev/null &&
+            cmp -s "${workdir}/whole.graph" "${workdir}/merged.graph" &&
+            cmp -s "${workdir}/whole.in.graph" "${workdir}/merged.in.graph" || status=1
+    fi
+    report "${name}" ${status}
+}
+
+check_part "part 3, spec" 3 10
+check_part "part 1, spec" 1 8
+check_part "part 40, more shards than edges" 40 3 --edgefactor 2
+check_part "part 7, philox, no self-loops" 7 10 --rng philox --no-self-loops
+check_part "part 4, partition 1/3, source range" 4 10 --partition 1/3 --source-range 100,900
+check_part "part 5, source-ordered, int32 weights" 5 10 --source-ordered --weight-type int32
+check_part "part 3, 3 x 3 initiator, 2000 vertices" 3 7 --initiator 0.4,0.2,0.1,0.1,0.05,0.05,0.05,0.02,0.03 --vertices 2000
+check_part "part 4, erdos-renyi" 4 9 --model erdos-renyi
+check_part "part 2, chung-lu" 2 9 --model chung-lu
+check_ranges "edge ranges, uneven and empty" 8 "0:1000 1000:1000 1000:1001 1001:4000 4000:4096"
+check_ranges "edge ranges, directed, fast sampler" 8 "0:2048 2048:4096" --directed --fast-sampler
+check_in_edges "part 3, directed, in-edges" 3 10
+check_in_edges "part 2, directed, in-edges, philox, noise" 2 9 --rng philox --noise 0.1
+
+if [ ${failures} -gt 0 ]; then
+    echo "ERROR: ${failures} check(s) of the shards failed" >&2
+    exit 1
+fi
+exit 0
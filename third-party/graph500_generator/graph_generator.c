@@ -15,18 +15,17 @@
 #define __STDC_FORMAT_MACROS
 #endif
 #include <inttypes.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "user_settings.h"
 #include "splittable_mrg.h"
 #include "graph_generator.h"
+#include "scramble.h"
 
-/* Initiator settings: for faster random number generation, the initiator
- * probabilities are defined as fractions (a = INITIATOR_A_NUMERATOR /
- * INITIATOR_DENOMINATOR, b = c = INITIATOR_BC_NUMERATOR /
- * INITIATOR_DENOMINATOR, d = 1 - a - b - c. */
-#define INITIATOR_A_NUMERATOR 5700
-#define INITIATOR_BC_NUMERATOR 1900
-#define INITIATOR_DENOMINATOR 10000
+/* The initiator settings, INITIATOR_A_NUMERATOR, INITIATOR_BC_NUMERATOR and
+ * INITIATOR_DENOMINATOR, are in graph_generator.h. */
 
 /* If this macro is defined to a non-zero value, use SPK_NOISE_LEVEL /
  * INITIATOR_DENOMINATOR as the noise parameter to use in introducing noise
@@ -77,78 +76,17 @@ static int generate_4way_bernoulli(mrg_state* st, int level, int nlevels) {
   return 3;
 }
 
-/* Reverse bits in a number; this should be optimized for performance
- * (including using bit- or byte-reverse intrinsics if your platform has them).
- * */
-static inline uint64_t bitreverse(uint64_t x) {
-#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3)
-#define USE_GCC_BYTESWAP /* __builtin_bswap* are in 4.3 but not 4.2 */
-#endif
-
-#ifdef FAST_64BIT_ARITHMETIC
-
-  /* 64-bit code */
-#ifdef USE_GCC_BYTESWAP
-  x = __builtin_bswap64(x);
-#else
-  x = (x >> 32) | (x << 32);
-  x = ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF)) | ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16);
-  x = ((x >>  8) & UINT64_C(0x00FF00FF00FF00FF)) | ((x & UINT64_C(0x00FF00FF00FF00FF)) <<  8);
-#endif
-  x = ((x >>  4) & UINT64_C(0x0F0F0F0F0F0F0F0F)) | ((x & UINT64_C(0x0F0F0F0F0F0F0F0F)) <<  4);
-  x = ((x >>  2) & UINT64_C(0x3333333333333333)) | ((x & UINT64_C(0x3333333333333333)) <<  2);
-  x = ((x >>  1) & UINT64_C(0x5555555555555555)) | ((x & UINT64_C(0x5555555555555555)) <<  1);
-  return x;
-
-#else
-
-  /* 32-bit code */
-  uint32_t h = (uint32_t)(x >> 32);
-  uint32_t l = (uint32_t)(x & UINT32_MAX);
-#ifdef USE_GCC_BYTESWAP
-  h = __builtin_bswap32(h);
-  l = __builtin_bswap32(l);
-#else
-  h = (h >> 16) | (h << 16);
-  l = (l >> 16) | (l << 16);
-  h = ((h >> 8) & UINT32_C(0x00FF00FF)) | ((h & UINT32_C(0x00FF00FF)) << 8);
-  l = ((l >> 8) & UINT32_C(0x00FF00FF)) | ((l & UINT32_C(0x00FF00FF)) << 8);
-#endif
-  h = ((h >> 4) & UINT32_C(0x0F0F0F0F)) | ((h & UINT32_C(0x0F0F0F0F)) << 4);
-  l = ((l >> 4) & UINT32_C(0x0F0F0F0F)) | ((l & UINT32_C(0x0F0F0F0F)) << 4);
-  h = ((h >> 2) & UINT32_C(0x33333333)) | ((h & UINT32_C(0x33333333)) << 2);
-  l = ((l >> 2) & UINT32_C(0x33333333)) | ((l & UINT32_C(0x33333333)) << 2);
-  h = ((h >> 1) & UINT32_C(0x55555555)) | ((h & UINT32_C(0x55555555)) << 1);
-  l = ((l >> 1) & UINT32_C(0x55555555)) | ((l & UINT32_C(0x55555555)) << 1);
-  return ((uint64_t)l << 32) | h; /* Swap halves */
-
-#endif
-}
-
-/* Apply a permutation to scramble vertex numbers; a randomly generated
- * permutation is not used because applying it at scale is too expensive. */
-static inline int64_t scramble(int64_t v0, int lgN, uint64_t val0, uint64_t val1) {
-  uint64_t v = (uint64_t)v0;
-  v += val0 + val1;
-  v *= (val0 | UINT64_C(0x4519840211493211));
-  v = (bitreverse(v) >> (64 - lgN));
-  assert ((v >> lgN) == 0);
-  v *= (val1 | UINT64_C(0x3050852102C843A5));
-  v = (bitreverse(v) >> (64 - lgN));
-  assert ((v >> lgN) == 0);
-  return (int64_t)v;
-}
-
-/* Make a single graph edge using a pre-set MRG state. */
+/* Make a single graph edge using a pre-set MRG state.  Directed graphs skip
+ * the clip-and-flip. */
 static
-void make_one_edge(int64_t nverts, int level, int lgN, mrg_state* st, packed_edge* result, uint64_t val0, uint64_t val1) {
+void make_one_edge(int64_t nverts, int level, int lgN, int directed, mrg_state* st, packed_edge* result, uint64_t val0, uint64_t val1) {
   int64_t base_src = 0, base_tgt = 0;
   while (nverts > 1) {
     int square = generate_4way_bernoulli(st, level, lgN);
     int src_offset = square / 2;
     int tgt_offset = square % 2;
-    assert (base_src <= base_tgt);
-    if (base_src == base_tgt) {
+    assert (directed || base_src <= base_tgt);
+    if (!directed && base_src == base_tgt) {
       /* Clip-and-flip for undirected graph */
       if (src_offset > tgt_offset) {
         int temp = src_offset;
@@ -166,51 +104,448 @@ void make_one_edge(int64_t nverts, int level, int lgN, mrg_state* st, packed_edg
              scramble(base_tgt, lgN, val0, val1));
 }
 
-/* Generate a range of edges (from start_edge to end_edge of the total graph),
- * writing into elements [0, end_edge - start_edge) of the edges array.  This
- * code is parallel on OpenMP and XMT; it must be used with
- * separately-implemented SPMD parallelism for MPI. */
-void generate_kronecker_range(
+/* Batched kernel: GENERATOR_BATCH_LANES consecutive edges are generated
+ * together, each lane carrying its own MRG state.  The lanes are held in GCC /
+ * Clang vector types, so the same code is lowered to AVX-512 (8 lanes, one
+ * register per state word), AVX2 (4 lanes, one register) or SSE2 (8 lanes,
+ * four registers) depending on the target flags.  With AVX2, 8 lanes would be
+ * split in halves of 16 bytes through the stack.
+ * The 4-way Bernoulli draw and the clip-and-flip are evaluated with lane
+ * masks instead of branches; the only data-dependent branch left is the
+ * rejection step of generate_4way_bernoulli, which fires with probability
+ * ~1.7e-6 per draw and is resolved per lane by the scalar code.  The output
+ * is bit-identical to make_one_edge.  Define GENERATOR_SCALAR_KERNEL to build
+ * the original edge-at-a-time loop instead. */
+#if defined(__AVX2__) && !defined(__AVX512F__)
+#define GENERATOR_BATCH_LANES 4
+#else
+#define GENERATOR_BATCH_LANES 8
+#endif
+
+#if defined(__GNUC__) && !defined(__MTA__) && !defined(GENERATOR_SCALAR_KERNEL) && SPK_NOISE_LEVEL == 0
+#define GENERATOR_BATCHED_KERNEL
+#endif
+
+#ifdef SSSP
+/* Store into weights[0, n) the weights drawn from the MRG values raw[0, n). */
+static inline void store_mrg_weights(void* weights, const weight_policy* policy, const uint32_t* raw, int n) {
+  int i;
+  if (policy->distribution == WEIGHT_UNIFORM && policy->type == WEIGHT_FLOAT && policy->min == 0 && policy->max == 1) {
+    /* The default policy, as store_weight, in a loop the compiler can vectorise */
+    for (i = 0; i < n; ++i) {
+      /* Same expression as mrg_get_float_orig */
+      ((float*)weights)[i] = (float)((float)raw[i] * .000000000465661287524579692);
+    }
+  } else {
+    for (i = 0; i < n; ++i) {
+      store_weight(weights, i, policy, raw[i], UINT32_C(0x7FFFFFFF), (float)((float)raw[i] * .000000000465661287524579692));
+    }
+  }
+}
+#endif
+
+#ifdef GENERATOR_BATCHED_KERNEL
+
+typedef uint64_t mrg_lanes_t __attribute__((vector_size(GENERATOR_BATCH_LANES * sizeof(uint64_t))));
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/* *r = *a * b on each lane, for lanes and b below 2^32, with the 32x32->64-bit
+ * multiplications (pmuludq).  Left to the compiler, the 64-bit products
+ * become three pmuludq with AVX2 and SSE2, and vpmullq with AVX-512DQ, which
+ * is slower and, on some cores, falsely depends on its destination register. */
+static inline void mrg_lanes_mul(mrg_lanes_t* r, const mrg_lanes_t* a, uint32_t b) {
+#if defined(__AVX512F__)
+  *(__m512i*)r = _mm512_mul_epu32(*(const __m512i*)a, _mm512_set1_epi64(b));
+#elif defined(__AVX2__)
+  size_t i;
+  for (i = 0; i < sizeof(mrg_lanes_t) / sizeof(__m256i); ++i) {
+    ((__m256i*)r)[i] = _mm256_mul_epu32(((const __m256i*)a)[i], _mm256_set1_epi64x(b));
+  }
+#elif defined(__SSE2__)
+  size_t i;
+  for (i = 0; i < sizeof(mrg_lanes_t) / sizeof(__m128i); ++i) {
+    ((__m128i*)r)[i] = _mm_mul_epu32(((const __m128i*)a)[i], _mm_set1_epi64x(b));
+  }
+#else
+  *r = *a * b;
+#endif
+}
+
+typedef struct mrg_lanes {
+  mrg_lanes_t z1, z2, z3, z4, z5;
+} mrg_lanes;
+
+/* val % INITIATOR_DENOMINATOR for val < 2^31, computed as a multiplication by
+ * the rounded-up reciprocal 2^45 / INITIATOR_DENOMINATOR.  The quotient is
+ * exact for all 31-bit values as long as the denominator is in (2^12, 2^14],
+ * and the reciprocal fits in 32 bits (mrg_lanes_mul) from 2^13 onwards. */
+#if INITIATOR_DENOMINATOR <= 8192 || INITIATOR_DENOMINATOR > 16384
+#error "The batched kernel requires INITIATOR_DENOMINATOR in (2^13, 2^14]"
+#endif
+#define INITIATOR_RECIPROCAL_SHIFT 45
+#define INITIATOR_RECIPROCAL (((UINT64_C(1) << INITIATOR_RECIPROCAL_SHIFT) / INITIATOR_DENOMINATOR) + 1)
+
+/* mrg_orig_step on all lanes; the new value is left in st->z1.  The product
+ * x * z1 + y * z5 is below 2^62 and is reduced modulo 2^31 - 1 without a
+ * division: since 2^31 == 1 modulo 2^31 - 1, fold the high bits onto the low
+ * ones twice, then subtract the modulus at most once. */
+static inline void mrg_lanes_step(mrg_lanes* st) {
+  mrg_lanes_t t, t5;
+  mrg_lanes_mul(&t, &st->z1, 107374182);
+  mrg_lanes_mul(&t5, &st->z5, 104480);
+  t += t5;
+  t = (t & 0x7FFFFFFF) + (t >> 31);
+  t = (t & 0x7FFFFFFF) + (t >> 31);
+  t -= (mrg_lanes_t)(t >= 0x7FFFFFFF) & 0x7FFFFFFF;
+  st->z5 = st->z4;
+  st->z4 = st->z3;
+  st->z3 = st->z2;
+  st->z2 = st->z1;
+  st->z1 = t;
+}
+
+/* Redo the rejection loop of generate_4way_bernoulli for a single lane */
+static void mrg_lanes_reject(mrg_lanes* st, int lane, uint32_t limit) {
+  mrg_state s;
+  uint32_t v;
+  s.z1 = (uint_fast32_t)st->z1[lane];
+  s.z2 = (uint_fast32_t)st->z2[lane];
+  s.z3 = (uint_fast32_t)st->z3[lane];
+  s.z4 = (uint_fast32_t)st->z4[lane];
+  s.z5 = (uint_fast32_t)st->z5[lane];
+  do {
+    v = mrg_get_uint_orig(&s);
+  } while (v < limit);
+  st->z1[lane] = s.z1;
+  st->z2[lane] = s.z2;
+  st->z3[lane] = s.z3;
+  st->z4[lane] = s.z4;
+  st->z5[lane] = s.z5;
+}
+
+/* Make GENERATOR_BATCH_LANES graph edges, lane i using the pre-set MRG state lanes[i]. */
+static void make_edge_batch(const mrg_state lanes[GENERATOR_BATCH_LANES], int lgN, int directed, packed_edge* result,
+#ifdef SSSP
+                            uint32_t* weight_values,
+#endif
+                            uint64_t val0, uint64_t val1) {
+  const uint32_t limit = (UINT32_C(0x7FFFFFFF) % INITIATOR_DENOMINATOR);
+  const uint64_t bc = INITIATOR_BC_NUMERATOR;
+  const uint64_t abc = INITIATOR_A_NUMERATOR + 2 * INITIATOR_BC_NUMERATOR;
+  mrg_lanes st;
+  mrg_lanes_t src = {0}, tgt = {0};
+  mrg_lanes_t diagonal = directed ? src : ~src; /* base_src == base_tgt so far, never for directed graphs */
+  int lane, level;
+
+  for (lane = 0; lane < GENERATOR_BATCH_LANES; ++lane) {
+    st.z1[lane] = lanes[lane].z1;
+    st.z2[lane] = lanes[lane].z2;
+    st.z3[lane] = lanes[lane].z3;
+    st.z4[lane] = lanes[lane].z4;
+    st.z5[lane] = lanes[lane].z5;
+  }
+
+  for (level = 0; level < lgN; ++level) {
+    mrg_lanes_t val, quotient, reject;
+    mrg_lanes_step(&st);
+    reject = (mrg_lanes_t)(st.z1 < limit);
+    uint64_t any_reject = 0;
+    for (lane = 0; lane < GENERATOR_BATCH_LANES; ++lane) any_reject |= reject[lane];
+    if (/* Unlikely */ any_reject) {
+      /* A copy, for st to stay in registers rather than in memory */
+      mrg_lanes rejected = st;
+      for (lane = 0; lane < GENERATOR_BATCH_LANES; ++lane) {
+        if (reject[lane]) mrg_lanes_reject(&rejected, lane, limit);
+      }
+      st = rejected;
+    }
+    val = st.z1;
+    mrg_lanes_mul(&quotient, &val, INITIATOR_RECIPROCAL);
+    quotient >>= INITIATOR_RECIPROCAL_SHIFT;
+    mrg_lanes_mul(&quotient, &quotient, INITIATOR_DENOMINATOR);
+    val -= quotient;
+
+    /* square 1 = (0, 1), square 2 = (1, 0), square 0 = (0, 0), square 3 = (1, 1) */
+    mrg_lanes_t is1 = (mrg_lanes_t)(val < bc);
+    mrg_lanes_t is2 = (mrg_lanes_t)(val < 2 * bc) & ~is1;
+    mrg_lanes_t is3 = (mrg_lanes_t)(val >= abc);
+    /* Clip-and-flip: on the diagonal square 2 is turned into square 1 */
+    src = (src << 1) | ((is3 | (is2 & ~diagonal)) & 1);
+    tgt = (tgt << 1) | ((is3 | is1 | (is2 & diagonal)) & 1);
+    diagonal &= ~(is1 | is2);
+  }
+
+#if defined(SCRAMBLE_LANES) && SCRAMBLE_LANES == GENERATOR_BATCH_LANES
+  scramble_lanes((scramble_lanes_t*)&src, lgN, val0, val1);
+  scramble_lanes((scramble_lanes_t*)&tgt, lgN, val0, val1);
+  for (lane = 0; lane < GENERATOR_BATCH_LANES; ++lane) {
+    write_edge(result + lane, (int64_t)src[lane], (int64_t)tgt[lane]);
+  }
+#else
+  for (lane = 0; lane < GENERATOR_BATCH_LANES; ++lane) {
+    write_edge(result + lane,
+               scramble((int64_t)src[lane], lgN, val0, val1),
+               scramble((int64_t)tgt[lane], lgN, val0, val1));
+  }
+#endif
+
+#ifdef SSSP
+  /* The values the weights are drawn from, see store_mrg_weights */
+  if (weight_values != NULL) {
+    mrg_lanes_step(&st);
+    for (lane = 0; lane < GENERATOR_BATCH_LANES; ++lane) weight_values[lane] = (uint32_t)st.z1[lane];
+  }
+#endif
+}
+
+#endif /* GENERATOR_BATCHED_KERNEL */
+
+/* Make a single graph edge and its weight, unless weight is NULL, from the MRG
+ * state of the edge. */
+static inline void make_one_edge_from(mrg_state st, int lgN, int directed, packed_edge* result,
+#ifdef SSSP
+                                      void* weight, const weight_policy* policy,
+#endif
+                                      uint64_t val0, uint64_t val1) {
+  make_one_edge((int64_t)1 << lgN, 0, lgN, directed, &st, result, val0, val1);
+#ifdef SSSP
+  if (weight != NULL) {
+    uint32_t raw = (uint32_t)mrg_get_uint_orig(&st);
+    store_mrg_weights(weight, policy, &raw, 1);
+  }
+#endif
+}
+
+#ifndef __MTA__
+/* Split [begin, end) evenly among the threads of the current parallel region. */
+static void get_thread_range(int64_t begin, int64_t end, int64_t* thread_begin, int64_t* thread_end) {
+#ifdef _OPENMP
+  int64_t num_threads = omp_get_num_threads();
+  int64_t thread_id = omp_get_thread_num();
+#else
+  int64_t num_threads = 1;
+  int64_t thread_id = 0;
+#endif
+  *thread_begin = begin + (end - begin) * thread_id / num_threads;
+  *thread_end = begin + (end - begin) * (thread_id + 1) / num_threads;
+}
+#endif
+
+/* Derive the values used by scramble() from the seed of the graph. */
+void make_scramble_values(const uint_fast32_t seed[5], uint64_t* val0, uint64_t* val1) {
+  mrg_state new_state;
+  mrg_seed(&new_state, seed);
+  mrg_skip(&new_state, 50, 7, 0);
+  *val0 = mrg_get_uint_orig(&new_state);
+  *val0 *= UINT64_C(0xFFFFFFFF);
+  *val0 += mrg_get_uint_orig(&new_state);
+  *val1 = mrg_get_uint_orig(&new_state);
+  *val1 *= UINT64_C(0xFFFFFFFF);
+  *val1 += mrg_get_uint_orig(&new_state);
+}
+
+/* Apply scramble() to both endpoints of the edges [0, n). */
+void scramble_edges(packed_edge* edges, int64_t n, int lgN, uint64_t val0, uint64_t val1) {
+#ifdef GENERATOR_USE_PACKED_EDGE_TYPE
+  /* Unpack the vertices of up to 64 edges at a time, scramble them together, pack them again */
+  int64_t vertices[128];
+  int64_t i, j, count;
+  for (i = 0; i < n; i += count) {
+    count = (n - i < 64) ? n - i : 64;
+    for (j = 0; j < count; ++j) {
+      vertices[2 * j] = get_v0_from_edge(edges + i + j);
+      vertices[2 * j + 1] = get_v1_from_edge(edges + i + j);
+    }
+    scramble_vertices(vertices, 2 * count, lgN, val0, val1);
+    for (j = 0; j < count; ++j) {
+      write_edge(edges + i + j, vertices[2 * j], vertices[2 * j + 1]);
+    }
+  }
+#else
+  /* The edges are pairs of int64_t, scramble them as a single array of vertices */
+  scramble_vertices(&edges->v0, 2 * n, lgN, val0, val1);
+#endif
+}
+
+/* generate_kronecker_range, for undirected (clip-and-flip) or directed graphs,
+ * with the values for scrambling of make_scramble_values. */
+static void generate_range(
        const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1), not all zero */,
+       uint64_t val0, uint64_t val1 /* Values for scrambling */,
        int logN /* In base 2 */,
+       int directed,
        int64_t start_edge, int64_t end_edge,
        packed_edge* edges
 #ifdef SSSP
-       , float* weights
+       , void* weights, const weight_policy* policy
 #endif
        ) {
   mrg_state state;
-  int64_t nverts = (int64_t)1 << logN;
   int64_t ei;
 
   mrg_seed(&state, seed);
 
-  uint64_t val0, val1; /* Values for scrambling */
-  {
-    mrg_state new_state = state;
-    mrg_skip(&new_state, 50, 7, 0);
-    val0 = mrg_get_uint_orig(&new_state);
-    val0 *= UINT64_C(0xFFFFFFFF);
-    val0 += mrg_get_uint_orig(&new_state);
-    val1 = mrg_get_uint_orig(&new_state);
-    val1 *= UINT64_C(0xFFFFFFFF);
-    val1 += mrg_get_uint_orig(&new_state);
-  }
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
 #ifdef __MTA__
 #pragma mta assert parallel
 #pragma mta block schedule
-#endif
   for (ei = start_edge; ei < end_edge; ++ei) {
     mrg_state new_state = state;
     mrg_skip(&new_state, 0, (uint64_t)ei, 0);
-    make_one_edge(nverts, 0, logN, &new_state, edges + (ei - start_edge), val0, val1);
+    make_one_edge_from(new_state, logN, directed, edges + (ei - start_edge),
+#ifdef SSSP
+                       weight_at(weights, ei - start_edge, policy->type), policy,
+#endif
+                       val0, val1);
+  }
+#else
+  /* Chunked stride advance: the state of the edge ei is A^(ei * 2^64) applied
+   * to the seed, so consecutive edges are exactly A^(2^64) apart.  Each thread
+   * seeds once with a full mrg_skip at the start of its chunk and then moves
+   * to the next edge with the single precomputed matrix for a skip of
+   * (stride, 0) in mrg_skip_matrices, rather than up to one matrix per
+   * non-zero byte of ei.  The states, and hence the edges, do not change. */
+#ifdef _OPENMP
+#pragma omp parallel private(ei)
+#endif
+  {
+    int64_t thread_begin, thread_end;
+    get_thread_range(start_edge, end_edge, &thread_begin, &thread_end);
+    ei = thread_begin;
+
+#ifdef GENERATOR_BATCHED_KERNEL
+    {
+      mrg_state lanes[GENERATOR_BATCH_LANES];
 #ifdef SSSP
-    weights[ei-start_edge]=mrg_get_float_orig(&new_state);
+      uint32_t weight_values[GENERATOR_BATCH_LANES];
 #endif
+      int lane;
+      lanes[0] = state;
+      mrg_skip(&lanes[0], 0, (uint64_t)thread_begin, 0);
+      for (lane = 1; lane < GENERATOR_BATCH_LANES; ++lane) {
+        lanes[lane] = lanes[lane - 1];
+        mrg_skip(&lanes[lane], 0, 1, 0);
+      }
+
+      for ( ; ei + GENERATOR_BATCH_LANES <= thread_end; ei += GENERATOR_BATCH_LANES) {
+        make_edge_batch(lanes, logN, directed, edges + (ei - start_edge),
+#ifdef SSSP
+                        (weights != NULL) ? weight_values : NULL,
+#endif
+                        val0, val1);
+#ifdef SSSP
+        if (weights != NULL) {
+          store_mrg_weights(weight_at(weights, ei - start_edge, policy->type), policy, weight_values, GENERATOR_BATCH_LANES);
+        }
+#endif
+        mrg_skip_many(lanes, GENERATOR_BATCH_LANES, 0, GENERATOR_BATCH_LANES, 0);
+      }
+
+      /* Fewer than GENERATOR_BATCH_LANES edges left, the lanes already hold their states */
+      for (lane = 0; ei < thread_end; ++ei, ++lane) {
+        make_one_edge_from(lanes[lane], logN, directed, edges + (ei - start_edge),
+#ifdef SSSP
+                           weight_at(weights, ei - start_edge, policy->type), policy,
+#endif
+                           val0, val1);
+      }
+    }
+#else
+    {
+      mrg_state new_state = state;
+      mrg_skip(&new_state, 0, (uint64_t)thread_begin, 0);
+      for ( ; ei < thread_end; ++ei) {
+        make_one_edge_from(new_state, logN, directed, edges + (ei - start_edge),
+#ifdef SSSP
+                           weight_at(weights, ei - start_edge, policy->type), policy,
+#endif
+                           val0, val1);
+        mrg_skip(&new_state, 0, 1, 0);
+      }
+    }
+#endif /* GENERATOR_BATCHED_KERNEL */
   }
+#endif /* __MTA__ */
 }
 
+/* Generate a range of edges (from start_edge to end_edge of the total graph),
+ * writing into elements [0, end_edge - start_edge) of the edges array, and of
+ * the weights array unless it is NULL.  This code is parallel on OpenMP and
+ * XMT; it must be used with separately-implemented SPMD parallelism for MPI. */
+void generate_kronecker_range(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1), not all zero */,
+       int logN /* In base 2 */,
+       int64_t start_edge, int64_t end_edge,
+       packed_edge* edges
+#ifdef SSSP
+       , float* weights
+#endif
+       ) {
+#ifdef SSSP
+  const weight_policy policy = WEIGHT_POLICY_DEFAULT;
+#endif
+  uint64_t val0, val1;
+  make_scramble_values(seed, &val0, &val1);
+  generate_range(seed, val0, val1, logN, 0, start_edge, end_edge, edges
+#ifdef SSSP
+                 , weights, &policy
+#endif
+                 );
+}
+
+/* As generate_kronecker_range, without the clip-and-flip: the edge (u, v) is
+ * directed, and u > v is possible. */
+void generate_kronecker_range_directed(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1), not all zero */,
+       int logN /* In base 2 */,
+       int64_t start_edge, int64_t end_edge,
+       packed_edge* edges
+#ifdef SSSP
+       , float* weights
+#endif
+       ) {
+#ifdef SSSP
+  const weight_policy policy = WEIGHT_POLICY_DEFAULT;
+#endif
+  uint64_t val0, val1;
+  make_scramble_values(seed, &val0, &val1);
+  generate_range(seed, val0, val1, logN, 1, start_edge, end_edge, edges
+#ifdef SSSP
+                 , weights, &policy
+#endif
+                 );
+}
+
+#ifdef SSSP
+/* As generate_kronecker_range, or generate_kronecker_range_directed, with the
+ * weights of the given policy. */
+void generate_kronecker_range_weighted(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1), not all zero */,
+       int logN /* In base 2 */,
+       int directed,
+       const weight_policy* policy,
+       int64_t start_edge, int64_t end_edge,
+       packed_edge* edges,
+       void* weights) {
+  uint64_t val0, val1;
+  make_scramble_values(seed, &val0, &val1);
+  generate_range(seed, val0, val1, logN, directed, start_edge, end_edge, edges, weights, policy);
+}
+
+/* As generate_kronecker_range_weighted, with the values for scrambling that
+ * make_scramble_values derived from the seed, for the callers that generate
+ * many ranges of the same graph. */
+void generate_kronecker_range_scrambled(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1), not all zero */,
+       uint64_t val0, uint64_t val1,
+       int logN /* In base 2 */,
+       int directed,
+       const weight_policy* policy,
+       int64_t start_edge, int64_t end_edge,
+       packed_edge* edges,
+       void* weights) {
+  generate_range(seed, val0, val1, logN, directed, start_edge, end_edge, edges, weights, policy);
+}
+#endif
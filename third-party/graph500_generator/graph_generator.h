@@ -11,6 +11,8 @@
 #define GRAPH_GENERATOR_H
 
 #include "user_settings.h"
+#include "kernel_isa.h"
+#include "weight_policy.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -20,6 +22,16 @@
 #endif
 #include <inttypes.h>
 
+/* Initiator settings: for faster random number generation, the initiator
+ * probabilities are defined as fractions (a = INITIATOR_A_NUMERATOR /
+ * INITIATOR_DENOMINATOR, b = c = INITIATOR_BC_NUMERATOR /
+ * INITIATOR_DENOMINATOR, d = 1 - a - b - c.  The C++ kernels and
+ * KroneckerParameters take their defaults from here, so that all the paths
+ * draw the same graph. */
+#define INITIATOR_A_NUMERATOR 5700
+#define INITIATOR_BC_NUMERATOR 1900
+#define INITIATOR_DENOMINATOR 10000
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -71,17 +83,68 @@ static inline void write_edge(packed_edge* p, int64_t v0, int64_t v1) {
 /* Generate a range of edges (from start_edge to end_edge of the total graph),
  * writing into elements [0, end_edge - start_edge) of the edges array.  This
  * code is parallel on OpenMP and XMT; it must be used with
- * separately-implemented SPMD parallelism for MPI. */
+ * separately-implemented SPMD parallelism for MPI.  With SSSP, the weights are
+ * written into the same elements of the weights array; a NULL weights array
+ * skips them, and the edges do not change. */
 void generate_kronecker_range(
        const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1) */,
        int logN /* In base 2 */,
        int64_t start_edge, int64_t end_edge /* Indices (in [0, M)) for the edges to generate */,
        packed_edge* edges /* Size >= end_edge - start_edge */
 #ifdef SSSP
-       ,float* weights
+       ,float* weights /* Size >= end_edge - start_edge, or NULL */
 #endif
 );
 
+/* As generate_kronecker_range, for directed graphs: the edges are not
+ * clipped-and-flipped, so (u, v) and (v, u) are distinct edges. */
+void generate_kronecker_range_directed(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1) */,
+       int logN /* In base 2 */,
+       int64_t start_edge, int64_t end_edge /* Indices (in [0, M)) for the edges to generate */,
+       packed_edge* edges /* Size >= end_edge - start_edge */
+#ifdef SSSP
+       ,float* weights /* Size >= end_edge - start_edge, or NULL */
+#endif
+);
+
+#ifdef SSSP
+/* As generate_kronecker_range, or generate_kronecker_range_directed if
+ * directed is non-zero, with the weights of the given policy (see
+ * weight_policy.h), stored at the width of its type. */
+void generate_kronecker_range_weighted(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1) */,
+       int logN /* In base 2 */,
+       int directed,
+       const weight_policy* policy,
+       int64_t start_edge, int64_t end_edge /* Indices (in [0, M)) for the edges to generate */,
+       packed_edge* edges /* Size >= end_edge - start_edge */,
+       void* weights /* Size >= end_edge - start_edge elements of the type of the policy, or NULL */);
+
+/* As generate_kronecker_range_weighted, with the values for scrambling
+ * computed once by make_scramble_values for the seed, rather than at each
+ * call. */
+void generate_kronecker_range_scrambled(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1) */,
+       uint64_t val0, uint64_t val1 /* From make_scramble_values(seed) */,
+       int logN /* In base 2 */,
+       int directed,
+       const weight_policy* policy,
+       int64_t start_edge, int64_t end_edge /* Indices (in [0, M)) for the edges to generate */,
+       packed_edge* edges /* Size >= end_edge - start_edge */,
+       void* weights /* Size >= end_edge - start_edge elements of the type of the policy, or NULL */);
+#endif
+
+/* Derive the two values used by scramble() (see scramble.h) to permute the
+ * vertex ids, for the graph generated from seed. */
+void make_scramble_values(
+       const uint_fast32_t seed[5] /* All values in [0, 2^31 - 1) */,
+       uint64_t* val0, uint64_t* val1 /* Output */);
+
+/* Apply scramble() (see scramble.h) to both endpoints of the edges [0, n),
+ * for generators that produce the unscrambled vertex ids first. */
+void scramble_edges(packed_edge* edges, int64_t n, int lgN, uint64_t val0, uint64_t val1);
+
 #ifdef __cplusplus
 }
 #endif
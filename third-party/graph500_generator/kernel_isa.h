@@ -0,0 +1,38 @@
+/* Use, modification and distribution is subject to the Boost Software     */
+/* License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at */
+/* http://www.boost.org/LICENSE_1_0.txt)                                   */
+
+#ifndef KERNEL_ISA_H
+#define KERNEL_ISA_H
+
+/* Kernel sets (see kernel_dispatch.hpp in the top directory): the generator
+ * is compiled once per instruction set, with -DKERNEL_ISA=<isa>, and linked
+ * in the same program.  The external symbols of graph_generator.c and
+ * splittable_mrg.c then take the suffix _<isa>, except in the primary set
+ * (-DKERNEL_ISA_PRIMARY), which keeps the plain names for the code built
+ * only once, such as utils.c. */
+#if defined(KERNEL_ISA) && !defined(KERNEL_ISA_PRIMARY)
+#define KERNEL_ISA_CONCAT_(name, isa) name##_##isa
+#define KERNEL_ISA_CONCAT(name, isa) KERNEL_ISA_CONCAT_(name, isa)
+#define KERNEL_ISA_NAME(name) KERNEL_ISA_CONCAT(name, KERNEL_ISA)
+
+/* graph_generator.c */
+#define generate_kronecker_range KERNEL_ISA_NAME(generate_kronecker_range)
+#define generate_kronecker_range_directed KERNEL_ISA_NAME(generate_kronecker_range_directed)
+#define generate_kronecker_range_weighted KERNEL_ISA_NAME(generate_kronecker_range_weighted)
+#define generate_kronecker_range_scrambled KERNEL_ISA_NAME(generate_kronecker_range_scrambled)
+#define make_scramble_values KERNEL_ISA_NAME(make_scramble_values)
+#define scramble_edges KERNEL_ISA_NAME(scramble_edges)
+
+/* splittable_mrg.c */
+#define mrg_get_uint_orig KERNEL_ISA_NAME(mrg_get_uint_orig)
+#define mrg_get_double_orig KERNEL_ISA_NAME(mrg_get_double_orig)
+#define mrg_get_float_orig KERNEL_ISA_NAME(mrg_get_float_orig)
+#define mrg_seed KERNEL_ISA_NAME(mrg_seed)
+#define mrg_skip KERNEL_ISA_NAME(mrg_skip)
+#define mrg_skip_many KERNEL_ISA_NAME(mrg_skip_many)
+#define mrg_skip_matrices KERNEL_ISA_NAME(mrg_skip_matrices)
+#define mrg_skip_matrices_radix16 KERNEL_ISA_NAME(mrg_skip_matrices_radix16)
+#endif
+
+#endif /* KERNEL_ISA_H */
@@ -23,7 +23,11 @@
 #include "mod_arith_xmt.h"
 #else
 #ifdef FAST_64BIT_ARITHMETIC
+#ifdef MERSENNE_MOD_ARITH
+#include "mod_arith_mersenne.h"
+#else
 #include "mod_arith_64bit.h"
+#endif
 #else
 #include "mod_arith_32bit.h"
 #endif
@@ -0,0 +1,93 @@
+/* Use, modification and distribution is subject to the Boost Software     */
+/* License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at */
+/* http://www.boost.org/LICENSE_1_0.txt)                                   */
+
+#ifndef MOD_ARITH_MERSENNE_H
+#define MOD_ARITH_MERSENNE_H
+
+#include <stdint.h>
+#include <assert.h>
+
+/* Modular arithmetic operations for modulus 2^31-1 (0x7FFFFFFF), with 64-bit
+ * arithmetic and without divisions.  Same results of mod_arith_64bit.h.
+ *
+ * The modulus is a Mersenne prime: 2^31 == 1 modulo 2^31-1, so the bits of a
+ * value above the 31st can be added back onto the low ones.  The products and
+ * the sums of up to four products of values below 2^31-1 fit in 64 bits, and
+ * are reduced only once, by mod_reduce. */
+
+/* x modulo 2^31-1, for any 64-bit x */
+static inline uint_fast32_t mod_reduce(uint_fast64_t x) {
+  x = (x & 0x7FFFFFFF) + (x >> 31); /* x <= 0x7FFFFFFF + 0x1FFFFFFFF */
+  x = (x & 0x7FFFFFFF) + (x >> 31); /* x <= 0x7FFFFFFF + 0x7 */
+  return (uint_fast32_t)((x >= 0x7FFFFFFF) ? (x - 0x7FFFFFFF) : x);
+}
+
+static inline uint_fast32_t mod_add(uint_fast32_t a, uint_fast32_t b) {
+  uint_fast32_t x;
+  assert (a <= 0x7FFFFFFE);
+  assert (b <= 0x7FFFFFFE);
+  x = a + b; /* x <= 0xFFFFFFFC */
+  return (x >= 0x7FFFFFFF) ? (x - 0x7FFFFFFF) : x;
+}
+
+static inline uint_fast32_t mod_mul(uint_fast32_t a, uint_fast32_t b) {
+  assert (a <= 0x7FFFFFFE);
+  assert (b <= 0x7FFFFFFE);
+  return mod_reduce((uint_fast64_t)a * b);
+}
+
+static inline uint_fast32_t mod_mac(uint_fast32_t sum, uint_fast32_t a, uint_fast32_t b) {
+  assert (sum <= 0x7FFFFFFE);
+  assert (a <= 0x7FFFFFFE);
+  assert (b <= 0x7FFFFFFE);
+  return mod_reduce((uint_fast64_t)a * b + sum);
+}
+
+static inline uint_fast32_t mod_mac2(uint_fast32_t sum, uint_fast32_t a, uint_fast32_t b, uint_fast32_t c, uint_fast32_t d) {
+  assert (sum <= 0x7FFFFFFE);
+  assert (a <= 0x7FFFFFFE);
+  assert (b <= 0x7FFFFFFE);
+  assert (c <= 0x7FFFFFFE);
+  assert (d <= 0x7FFFFFFE);
+  return mod_reduce((uint_fast64_t)a * b + (uint_fast64_t)c * d + sum);
+}
+
+static inline uint_fast32_t mod_mac3(uint_fast32_t sum, uint_fast32_t a, uint_fast32_t b, uint_fast32_t c, uint_fast32_t d, uint_fast32_t e, uint_fast32_t f) {
+  assert (sum <= 0x7FFFFFFE);
+  assert (a <= 0x7FFFFFFE);
+  assert (b <= 0x7FFFFFFE);
+  assert (c <= 0x7FFFFFFE);
+  assert (d <= 0x7FFFFFFE);
+  assert (e <= 0x7FFFFFFE);
+  assert (f <= 0x7FFFFFFE);
+  return mod_reduce((uint_fast64_t)a * b + (uint_fast64_t)c * d + (uint_fast64_t)e * f + sum);
+}
+
+static inline uint_fast32_t mod_mac4(uint_fast32_t sum, uint_fast32_t a, uint_fast32_t b, uint_fast32_t c, uint_fast32_t d, uint_fast32_t e, uint_fast32_t f, uint_fast32_t g, uint_fast32_t h) {
+  assert (sum <= 0x7FFFFFFE);
+  assert (a <= 0x7FFFFFFE);
+  assert (b <= 0x7FFFFFFE);
+  assert (c <= 0x7FFFFFFE);
+  assert (d <= 0x7FFFFFFE);
+  assert (e <= 0x7FFFFFFE);
+  assert (f <= 0x7FFFFFFE);
+  assert (g <= 0x7FFFFFFE);
+  assert (h <= 0x7FFFFFFE);
+  /* 4 * 0x7FFFFFFE^2 + 0x7FFFFFFE < 2^64 */
+  return mod_reduce((uint_fast64_t)a * b + (uint_fast64_t)c * d + (uint_fast64_t)e * f + (uint_fast64_t)g * h + sum);
+}
+
+static inline uint_fast32_t mod_mul_x(uint_fast32_t a) {
+  return mod_mul(a, 107374182);
+}
+
+static inline uint_fast32_t mod_mul_y(uint_fast32_t a) {
+  return mod_mul(a, 104480);
+}
+
+static inline uint_fast32_t mod_mac_y(uint_fast32_t sum, uint_fast32_t a) {
+  return mod_mac(sum, a, 104480);
+}
+
+#endif /* MOD_ARITH_MERSENNE_H */
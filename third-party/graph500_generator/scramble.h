@@ -0,0 +1,209 @@
+/* Copyright (C) 2009-2010 The Trustees of Indiana University.             */
+/*                                                                         */
+/* Use, modification and distribution is subject to the Boost Software     */
+/* License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at */
+/* http://www.boost.org/LICENSE_1_0.txt)                                   */
+/*                                                                         */
+/*  Authors: Jeremiah Willcock                                             */
+/*           Andrew Lumsdaine                                              */
+
+#ifndef SCRAMBLE_H
+#define SCRAMBLE_H
+
+#include <stdint.h>
+#include <assert.h>
+#include "user_settings.h"
+
+/* The vertex permutation of generate_kronecker_range, shared with the
+ * generators outside graph_generator.c.  The values val0 and val1 come from
+ * make_scramble_values() in graph_generator.h. */
+
+/* Reverse bits in a number; this should be optimized for performance
+ * (including using bit- or byte-reverse intrinsics if your platform has them).
+ * */
+static inline uint64_t bitreverse(uint64_t x) {
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 3)
+#define USE_GCC_BYTESWAP /* __builtin_bswap* are in 4.3 but not 4.2 */
+#endif
+
+#ifdef FAST_64BIT_ARITHMETIC
+
+  /* 64-bit code */
+#ifdef USE_GCC_BYTESWAP
+  x = __builtin_bswap64(x);
+#else
+  x = (x >> 32) | (x << 32);
+  x = ((x >> 16) & UINT64_C(0x0000FFFF0000FFFF)) | ((x & UINT64_C(0x0000FFFF0000FFFF)) << 16);
+  x = ((x >>  8) & UINT64_C(0x00FF00FF00FF00FF)) | ((x & UINT64_C(0x00FF00FF00FF00FF)) <<  8);
+#endif
+  x = ((x >>  4) & UINT64_C(0x0F0F0F0F0F0F0F0F)) | ((x & UINT64_C(0x0F0F0F0F0F0F0F0F)) <<  4);
+  x = ((x >>  2) & UINT64_C(0x3333333333333333)) | ((x & UINT64_C(0x3333333333333333)) <<  2);
+  x = ((x >>  1) & UINT64_C(0x5555555555555555)) | ((x & UINT64_C(0x5555555555555555)) <<  1);
+  return x;
+
+#else
+
+  /* 32-bit code */
+  uint32_t h = (uint32_t)(x >> 32);
+  uint32_t l = (uint32_t)(x & UINT32_MAX);
+#ifdef USE_GCC_BYTESWAP
+  h = __builtin_bswap32(h);
+  l = __builtin_bswap32(l);
+#else
+  h = (h >> 16) | (h << 16);
+  l = (l >> 16) | (l << 16);
+  h = ((h >> 8) & UINT32_C(0x00FF00FF)) | ((h & UINT32_C(0x00FF00FF)) << 8);
+  l = ((l >> 8) & UINT32_C(0x00FF00FF)) | ((l & UINT32_C(0x00FF00FF)) << 8);
+#endif
+  h = ((h >> 4) & UINT32_C(0x0F0F0F0F)) | ((h & UINT32_C(0x0F0F0F0F)) << 4);
+  l = ((l >> 4) & UINT32_C(0x0F0F0F0F)) | ((l & UINT32_C(0x0F0F0F0F)) << 4);
+  h = ((h >> 2) & UINT32_C(0x33333333)) | ((h & UINT32_C(0x33333333)) << 2);
+  l = ((l >> 2) & UINT32_C(0x33333333)) | ((l & UINT32_C(0x33333333)) << 2);
+  h = ((h >> 1) & UINT32_C(0x55555555)) | ((h & UINT32_C(0x55555555)) << 1);
+  l = ((l >> 1) & UINT32_C(0x55555555)) | ((l & UINT32_C(0x55555555)) << 1);
+  return ((uint64_t)l << 32) | h; /* Swap halves */
+
+#endif
+}
+
+/* Apply a permutation to scramble vertex numbers; a randomly generated
+ * permutation is not used because applying it at scale is too expensive. */
+static inline int64_t scramble(int64_t v0, int lgN, uint64_t val0, uint64_t val1) {
+  uint64_t v = (uint64_t)v0;
+  v += val0 + val1;
+  v *= (val0 | UINT64_C(0x4519840211493211));
+  v = (bitreverse(v) >> (64 - lgN));
+  assert ((v >> lgN) == 0);
+  v *= (val1 | UINT64_C(0x3050852102C843A5));
+  v = (bitreverse(v) >> (64 - lgN));
+  assert ((v >> lgN) == 0);
+  return (int64_t)v;
+}
+
+/* The inverse of an odd number modulo 2^64, by Newton's iteration: each step
+ * doubles the number of correct low bits, from the 3 of x = m. */
+static inline uint64_t inverse_odd(uint64_t m) {
+  uint64_t x = m;
+  int i;
+  assert((m & 1) == 1);
+  for (i = 0; i < 5; ++i) x *= 2 - m * x;
+  return x;
+}
+
+/* The inverse permutation of scramble(), over the same val0 and val1: the
+ * vertex ids of the output back to their positions in the Kronecker
+ * recursion.  Only the low lgN bits of the products of scramble() reach its
+ * output, so each step is undone modulo 2^lgN: the bit reversals are their
+ * own inverse and the multipliers are odd. */
+static inline int64_t inverse_scramble(int64_t v0, int lgN, uint64_t val0, uint64_t val1) {
+  const uint64_t mask = (UINT64_C(1) << lgN) - 1;
+  uint64_t v = (uint64_t)v0;
+  assert((v >> lgN) == 0);
+  v = bitreverse(v) >> (64 - lgN);
+  v = (v * inverse_odd(val1 | UINT64_C(0x3050852102C843A5))) & mask;
+  v = bitreverse(v) >> (64 - lgN);
+  v = (v * inverse_odd(val0 | UINT64_C(0x4519840211493211))) & mask;
+  v = (v - (val0 + val1)) & mask;
+  return (int64_t)v;
+}
+
+/* Vectorised scramble: SCRAMBLE_LANES vertex ids at a time, held in a GCC /
+ * Clang vector type.  Permuting the vertex ids is then a separate stage,
+ * applied to a whole batch or block of edges once the recursion is done,
+ * rather than two scalar calls at the end of each edge.  The byte reversal of
+ * bitreverse is a byte shuffle (pshufb); the bit reversal inside each byte is
+ * a single GF(2) affine transform with GFNI (vgf2p8affineqb), or two lookups
+ * into a nibble table otherwise.  It needs AVX2: with SSE2 only, the 64-bit
+ * multiplications and the shift-mask ladder on the vector are slower than the
+ * scalar code.  The output is the same of scramble().  Define SCRAMBLE_SCALAR
+ * to use the scalar code only. */
+#if defined(__GNUC__) && !defined(__MTA__) && !defined(SCRAMBLE_SCALAR) && defined(__AVX2__)
+#define SCRAMBLE_LANES 8
+
+#include <string.h>
+#include <immintrin.h>
+
+typedef uint64_t scramble_lanes_t __attribute__((vector_size(SCRAMBLE_LANES * sizeof(uint64_t))));
+
+#if defined(__AVX512BW__)
+#define SCRAMBLE_VECTOR_BYTES 64
+typedef __m512i scramble_vector_t;
+#define scramble_shuffle_epi8 _mm512_shuffle_epi8
+#define scramble_srli_epi16 _mm512_srli_epi16
+#define scramble_and _mm512_and_si512
+#define scramble_or _mm512_or_si512
+#define scramble_set1_epi8 _mm512_set1_epi8
+#define scramble_set1_epi64 _mm512_set1_epi64
+#define scramble_broadcast128 _mm512_broadcast_i32x4
+#define scramble_gf2p8affine _mm512_gf2p8affine_epi64_epi8
+#else
+#define SCRAMBLE_VECTOR_BYTES 32
+typedef __m256i scramble_vector_t;
+#define scramble_shuffle_epi8 _mm256_shuffle_epi8
+#define scramble_srli_epi16 _mm256_srli_epi16
+#define scramble_and _mm256_and_si256
+#define scramble_or _mm256_or_si256
+#define scramble_set1_epi8 _mm256_set1_epi8
+#define scramble_set1_epi64 _mm256_set1_epi64x
+#define scramble_broadcast128 _mm256_broadcastsi128_si256
+#define scramble_gf2p8affine _mm256_gf2p8affine_epi64_epi8
+#endif
+
+/* The lanes are passed by pointer: vector arguments wider than the enabled
+ * ISA trigger the -Wpsabi warnings */
+static inline void bitreverse_lanes(scramble_lanes_t* v) {
+  scramble_vector_t parts[sizeof(scramble_lanes_t) / SCRAMBLE_VECTOR_BYTES];
+  const scramble_vector_t byteswap = scramble_broadcast128(_mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8));
+#ifdef __GFNI__
+  const scramble_vector_t reverse_matrix = scramble_set1_epi64(INT64_C(0x8040201008040201));
+#else
+  /* bit-reversed nibbles, already shifted in the high or low half of the byte */
+  const scramble_vector_t reverse_low = scramble_broadcast128(_mm_setr_epi8(0x00, (char)0x80, 0x40, (char)0xC0, 0x20, (char)0xA0, 0x60, (char)0xE0, 0x10, (char)0x90, 0x50, (char)0xD0, 0x30, (char)0xB0, 0x70, (char)0xF0));
+  const scramble_vector_t reverse_high = scramble_broadcast128(_mm_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF));
+  const scramble_vector_t low_nibble = scramble_set1_epi8(0x0F);
+#endif
+  size_t i;
+  memcpy(parts, v, sizeof(parts));
+  for (i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
+    scramble_vector_t x = scramble_shuffle_epi8(parts[i], byteswap);
+#ifdef __GFNI__
+    x = scramble_gf2p8affine(x, reverse_matrix, 0);
+#else
+    x = scramble_or(scramble_shuffle_epi8(reverse_low, scramble_and(x, low_nibble)),
+                    scramble_shuffle_epi8(reverse_high, scramble_and(scramble_srli_epi16(x, 4), low_nibble)));
+#endif
+    parts[i] = x;
+  }
+  memcpy(v, parts, sizeof(parts));
+}
+
+/* scramble() on all lanes */
+static inline void scramble_lanes(scramble_lanes_t* v, int lgN, uint64_t val0, uint64_t val1) {
+  *v += val0 + val1;
+  *v *= (val0 | UINT64_C(0x4519840211493211));
+  bitreverse_lanes(v);
+  *v >>= (64 - lgN);
+  *v *= (val1 | UINT64_C(0x3050852102C843A5));
+  bitreverse_lanes(v);
+  *v >>= (64 - lgN);
+}
+#endif
+
+/* Scramble the vertex ids v[0, n) in place, as v[i] = scramble(v[i], ...). */
+static inline void scramble_vertices(int64_t* v, int64_t n, int lgN, uint64_t val0, uint64_t val1) {
+  int64_t i = 0;
+#ifdef SCRAMBLE_LANES
+  int64_t num_vectors = n / SCRAMBLE_LANES;
+  for ( ; num_vectors > 0; --num_vectors, i += SCRAMBLE_LANES) {
+    scramble_lanes_t x;
+    memcpy(&x, v + i, sizeof(x));
+    scramble_lanes(&x, lgN, val0, val1);
+    memcpy(v + i, &x, sizeof(x));
+  }
+#endif
+  for ( ; i < n; ++i) {
+    v[i] = scramble(v[i], lgN, val0, val1);
+  }
+}
+
+#endif /* SCRAMBLE_H */
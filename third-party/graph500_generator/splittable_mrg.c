@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 #include "mod_arith.h"
@@ -56,13 +57,31 @@
 /* v3 = s1 b2 y + t1 a2 y + u1 s2 y + v1 w2 + w1 v2,                     */
 /* w3 = s1 c2 y + t1 b2 y + u1 a2 y + v1 s2 y + w1 w2                    */
 
+/* With MRG_PACKED_SKIP_TABLE (see user_settings.h), the elements of the   */
+/* matrices take 32 bits rather than the 64 bits of uint_fast32_t on      */
+/* x86-64: a matrix is 36 bytes and mrg_skip_matrices half the size, and  */
+/* the rows of the table start on a cache line.                          */
+#ifdef MRG_PACKED_SKIP_TABLE
+typedef uint_least32_t mrg_matrix_element;
+#else
+typedef uint_fast32_t mrg_matrix_element;
+#endif
+#if defined(MRG_PACKED_SKIP_TABLE) && defined(__GNUC__)
+#define MRG_SKIP_TABLE_ALIGNMENT __attribute__((aligned(64)))
+#else
+#define MRG_SKIP_TABLE_ALIGNMENT
+#endif
+
+/* Number of 16-bit digits of exponent_middle in mrg_skip_matrices_radix16 */
+#define MRG_RADIX16_DIGITS 2
+
 typedef struct mrg_transition_matrix {
-  uint_fast32_t s, t, u, v, w;
+  mrg_matrix_element s, t, u, v, w;
   /* Cache for other parts of matrix (see mrg_update_cache function)     */
-  uint_fast32_t a, b, c, d;
+  mrg_matrix_element a, b, c, d;
 } mrg_transition_matrix;
 
-#ifdef DUMP_TRANSITION_TABLE
+#if defined(DUMP_TRANSITION_TABLE) || defined(CHECK_TRANSITION_TABLE)
 static void mrg_update_cache(mrg_transition_matrix* restrict p) { /* Set a, b, c, and d */
   p->a = mod_add(mod_mul_x(p->s), p->t);
   p->b = mod_add(mod_mul_x(p->a), p->u);
@@ -181,16 +200,35 @@ static void mrg_orig_step(mrg_state* state) { /* Use original A, not fully optim
 #include "mrg_transitions.c"
 /* Defines this:
 extern const mrg_transition_matrix mrg_skip_matrices[][256]; */
+#ifdef MRG_SKIP_RADIX16
+#include "mrg_transitions_radix16.c"
+/* Defines this, A^(2^64 * j * 65536^digit) for the low 32 bits of
+ * exponent_middle:
+extern const mrg_transition_matrix mrg_skip_matrices_radix16[MRG_RADIX16_DIGITS][65536]; */
+#endif
+#else
+static const mrg_transition_matrix mrg_skip_matrices[192 / 8][256]; /* Dummy version, all zeros */
+#undef MRG_SKIP_RADIX16
 #endif
 
 void mrg_skip(mrg_state* state, uint_least64_t exponent_high, uint_least64_t exponent_middle, uint_least64_t exponent_low) {
   /* fprintf(stderr, "skip(%016" PRIXLEAST64 "%016" PRIXLEAST64 "%016" PRIXLEAST64 ")\n", exponent_high, exponent_middle, exponent_low); */
   int byte_index;
+#ifdef MRG_SKIP_RADIX16
+  int digit;
+#endif
   for (byte_index = 0; exponent_low; ++byte_index, exponent_low >>= 8) {
     uint_least8_t val = (uint_least8_t)(exponent_low & 0xFF);
     if (val != 0) mrg_step(&mrg_skip_matrices[byte_index][val], state);
   }
-  for (byte_index = 8; exponent_middle; ++byte_index, exponent_middle >>= 8) {
+  byte_index = 8;
+#ifdef MRG_SKIP_RADIX16
+  for (digit = 0; digit < MRG_RADIX16_DIGITS && exponent_middle; ++digit, byte_index += 2, exponent_middle >>= 16) {
+    uint_least16_t val = (uint_least16_t)(exponent_middle & 0xFFFF);
+    if (val != 0) mrg_step(&mrg_skip_matrices_radix16[digit][val], state);
+  }
+#endif
+  for ( ; exponent_middle; ++byte_index, exponent_middle >>= 8) {
     uint_least8_t val = (uint_least8_t)(exponent_middle & 0xFF);
     if (val != 0) mrg_step(&mrg_skip_matrices[byte_index][val], state);
   }
@@ -200,23 +238,128 @@ void mrg_skip(mrg_state* state, uint_least64_t exponent_high, uint_least64_t exp
   }
 }
 
-#ifdef DUMP_TRANSITION_TABLE
-const mrg_transition_matrix mrg_skip_matrices[][256] = {}; /* Dummy version */
+/* Apply one transition matrix to many states at a time, in SIMD registers.
+ * The lanes are 64-bit and the 31x31-bit products use the 32x32->64-bit
+ * multiplications (pmuludq), as the products of 62 bits do not fit in the
+ * 52-bit multipliers of AVX-512 IFMA.  Each row of the matrix is a dot
+ * product of five terms, reduced modulo 2^31-1 as in mod_arith_mersenne.h. */
+#if defined(__GNUC__) && !defined(__MTA__) && defined(FAST_64BIT_ARITHMETIC)
+#if defined(__AVX512F__)
+#define MRG_VECTOR_LANES 8
+#elif defined(__AVX2__)
+#define MRG_VECTOR_LANES 4
+#else
+#define MRG_VECTOR_LANES 2
+#endif
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+typedef uint64_t mrg_vector_t __attribute__((vector_size(MRG_VECTOR_LANES * sizeof(uint64_t))));
+
+/* a * b on each lane, for values below 2^32 */
+static inline mrg_vector_t mrg_vector_mul(mrg_vector_t a, mrg_vector_t b) {
+#if defined(__AVX512F__)
+  return (mrg_vector_t)_mm512_mul_epu32((__m512i)a, (__m512i)b);
+#elif defined(__AVX2__)
+  return (mrg_vector_t)_mm256_mul_epu32((__m256i)a, (__m256i)b);
+#elif defined(__SSE2__)
+  return (mrg_vector_t)_mm_mul_epu32((__m128i)a, (__m128i)b);
+#else
+  return a * b;
+#endif
+}
+
+/* x modulo 2^31-1 on each lane */
+static inline mrg_vector_t mrg_vector_reduce(mrg_vector_t x) {
+  x = (x & 0x7FFFFFFF) + (x >> 31);
+  x = (x & 0x7FFFFFFF) + (x >> 31);
+  return x - ((mrg_vector_t)(x >= 0x7FFFFFFF) & 0x7FFFFFFF);
+}
+
+/* m1 * z1 + ... + m5 * z5 modulo 2^31-1; the first four products fit in 64 bits */
+static inline mrg_vector_t mrg_vector_dot5(uint_fast32_t m1, uint_fast32_t m2, uint_fast32_t m3, uint_fast32_t m4, uint_fast32_t m5,
+                                           mrg_vector_t z1, mrg_vector_t z2, mrg_vector_t z3, mrg_vector_t z4, mrg_vector_t z5) {
+  const mrg_vector_t zero = {0};
+  mrg_vector_t sum = mrg_vector_mul(zero + m1, z1) + mrg_vector_mul(zero + m2, z2) + mrg_vector_mul(zero + m3, z3) + mrg_vector_mul(zero + m4, z4);
+  return mrg_vector_reduce(mrg_vector_reduce(sum) + mrg_vector_mul(zero + m5, z5));
+}
+#endif
+
+/* mrg_step on the states [0, n) */
+static void mrg_step_many(const mrg_transition_matrix* mat, mrg_state* states, size_t n) {
+  size_t i = 0;
+#ifdef MRG_VECTOR_LANES
+  const uint_fast32_t sy = mod_mul_y(mat->s), ay = mod_mul_y(mat->a), by = mod_mul_y(mat->b), cy = mod_mul_y(mat->c);
+  for ( ; i + MRG_VECTOR_LANES <= n; i += MRG_VECTOR_LANES) {
+    mrg_vector_t z1, z2, z3, z4, z5;
+    size_t lane;
+    for (lane = 0; lane < MRG_VECTOR_LANES; ++lane) {
+      z1[lane] = states[i + lane].z1;
+      z2[lane] = states[i + lane].z2;
+      z3[lane] = states[i + lane].z3;
+      z4[lane] = states[i + lane].z4;
+      z5[lane] = states[i + lane].z5;
+    }
+    /* the rows of A^n, see the top of this file */
+    mrg_vector_t o1 = mrg_vector_dot5(mat->d, sy, ay, by, cy, z1, z2, z3, z4, z5);
+    mrg_vector_t o2 = mrg_vector_dot5(mat->c, mat->w, sy, ay, by, z1, z2, z3, z4, z5);
+    mrg_vector_t o3 = mrg_vector_dot5(mat->b, mat->v, mat->w, sy, ay, z1, z2, z3, z4, z5);
+    mrg_vector_t o4 = mrg_vector_dot5(mat->a, mat->u, mat->v, mat->w, sy, z1, z2, z3, z4, z5);
+    mrg_vector_t o5 = mrg_vector_dot5(mat->s, mat->t, mat->u, mat->v, mat->w, z1, z2, z3, z4, z5);
+    for (lane = 0; lane < MRG_VECTOR_LANES; ++lane) {
+      states[i + lane].z1 = (uint_fast32_t)o1[lane];
+      states[i + lane].z2 = (uint_fast32_t)o2[lane];
+      states[i + lane].z3 = (uint_fast32_t)o3[lane];
+      states[i + lane].z4 = (uint_fast32_t)o4[lane];
+      states[i + lane].z5 = (uint_fast32_t)o5[lane];
+    }
+  }
+#endif
+  for ( ; i < n; ++i) {
+    mrg_step(mat, &states[i]);
+  }
+}
+
+void mrg_skip_many(mrg_state* states, size_t n, uint_least64_t exponent_high, uint_least64_t exponent_middle, uint_least64_t exponent_low) {
+  int byte_index;
+#ifdef MRG_SKIP_RADIX16
+  int digit;
+#endif
+  for (byte_index = 0; exponent_low; ++byte_index, exponent_low >>= 8) {
+    uint_least8_t val = (uint_least8_t)(exponent_low & 0xFF);
+    if (val != 0) mrg_step_many(&mrg_skip_matrices[byte_index][val], states, n);
+  }
+  byte_index = 8;
+#ifdef MRG_SKIP_RADIX16
+  for (digit = 0; digit < MRG_RADIX16_DIGITS && exponent_middle; ++digit, byte_index += 2, exponent_middle >>= 16) {
+    uint_least16_t val = (uint_least16_t)(exponent_middle & 0xFFFF);
+    if (val != 0) mrg_step_many(&mrg_skip_matrices_radix16[digit][val], states, n);
+  }
+#endif
+  for ( ; exponent_middle; ++byte_index, exponent_middle >>= 8) {
+    uint_least8_t val = (uint_least8_t)(exponent_middle & 0xFF);
+    if (val != 0) mrg_step_many(&mrg_skip_matrices[byte_index][val], states, n);
+  }
+  for (byte_index = 16; exponent_high; ++byte_index, exponent_high >>= 8) {
+    uint_least8_t val = (uint_least8_t)(exponent_high & 0xFF);
+    if (val != 0) mrg_step_many(&mrg_skip_matrices[byte_index][val], states, n);
+  }
+}
 
+#ifdef DUMP_TRANSITION_TABLE
 void dump_mrg(FILE* out, const mrg_transition_matrix* m) {
   /* This is used as an initializer for the mrg_transition_matrix struct, so
    * the order of the fields here needs to match the struct
-   * mrg_transition_matrix definition in splittable_mrg.h */
-  fprintf(out, "{%" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 "}\n", m->s, m->t, m->u, m->v, m->w, m->a, m->b, m->c, m->d);
+   * mrg_transition_matrix definition above */
+  const uint_fast32_t f[9] = {m->s, m->t, m->u, m->v, m->w, m->a, m->b, m->c, m->d};
+  fprintf(out, "{%" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 ", %" PRIuFAST32 "}\n", f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8]);
 }
 
-void dump_mrg_powers(void) {
-  /* transitions contains A^(256^n) for n in 0 .. 192/8 */
-  int i, j;
-  mrg_transition_matrix transitions[192 / 8];
-  FILE* out = fopen("mrg_transitions.c", "w");
+static FILE* dump_mrg_open(const char* filename) {
+  FILE* out = fopen(filename, "w");
   if (!out) {
-    fprintf(stderr, "dump_mrg_powers: could not open mrg_transitions.c for output\n");
+    fprintf(stderr, "dump_mrg_powers: could not open %s for output\n", filename);
     exit (1);
   }
   fprintf(out, "/* Copyright (C) 2010 The Trustees of Indiana University.                  */\n");
@@ -229,40 +372,166 @@ void dump_mrg_powers(void) {
   fprintf(out, "/*           Andrew Lumsdaine                                              */\n");
   fprintf(out, "\n");
   fprintf(out, "/* This code was generated by dump_mrg_powers() in splittable_mrg.c;\n * look there for how to rebuild the table. */\n\n");
-  fprintf(out, "#include \"splittable_mrg.h\"\n");
-  fprintf(out, "const mrg_transition_matrix mrg_skip_matrices[][256] = {\n");
+  return out;
+}
+
+/* radix == 8: mrg_skip_matrices in mrg_transitions.c, with A^(j * 256^n) for
+ * the bytes n in 0 .. 192/8 of the exponent.
+ * radix == 16: mrg_skip_matrices_radix16 in mrg_transitions_radix16.c, with
+ * A^(2^64 * j * 65536^n) for the 16-bit digits n of exponent_middle in
+ * 0 .. MRG_RADIX16_DIGITS. */
+void dump_mrg_powers(int radix) {
+  /* transitions contains A^(256^n) for n in 0 .. 192/8 */
+  int i, j;
+  mrg_transition_matrix transitions[192 / 8];
+  mrg_transition_matrix m;
+  FILE* out;
   for (i = 0; i < 192 / 8; ++i) {
-    if (i != 0) fprintf(out, ",");
-    fprintf(out, "/* Byte %d */ {\n", i);
-    mrg_transition_matrix m;
-    mrg_make_identity(&m);
-    dump_mrg(out, &m);
     if (i == 0) {
       mrg_make_A(&transitions[i]);
     } else {
       mrg_power(&transitions[i - 1], 256, &transitions[i]);
     }
-    fprintf(out, ",");
-    dump_mrg(out, &transitions[i]);
-    for (j = 2; j < 256; ++j) {
-      fprintf(out, ",");
-      mrg_power(&transitions[i], j, &m);
+  }
+  if (radix == 16) {
+    out = dump_mrg_open("mrg_transitions_radix16.c");
+    fprintf(out, "const mrg_transition_matrix mrg_skip_matrices_radix16[][65536] MRG_SKIP_TABLE_ALIGNMENT = {\n");
+    for (i = 0; i < MRG_RADIX16_DIGITS; ++i) {
+      if (i != 0) fprintf(out, ",");
+      fprintf(out, "/* Digit %d */ {\n", i);
+      mrg_make_identity(&m);
+      for (j = 0; j < 65536; ++j) {
+        if (j != 0) fprintf(out, ",");
+        dump_mrg(out, &m);
+        mrg_multiply(&m, &transitions[8 + 2 * i], &m);
+      }
+      fprintf(out, "} /* End of digit %d */\n", i);
+    }
+  } else {
+    out = dump_mrg_open("mrg_transitions.c");
+    fprintf(out, "#include \"splittable_mrg.h\"\n");
+    fprintf(out, "const mrg_transition_matrix mrg_skip_matrices[][256] MRG_SKIP_TABLE_ALIGNMENT = {\n");
+    for (i = 0; i < 192 / 8; ++i) {
+      if (i != 0) fprintf(out, ",");
+      fprintf(out, "/* Byte %d */ {\n", i);
+      mrg_make_identity(&m);
       dump_mrg(out, &m);
+      fprintf(out, ",");
+      dump_mrg(out, &transitions[i]);
+      for (j = 2; j < 256; ++j) {
+        fprintf(out, ",");
+        mrg_power(&transitions[i], j, &m);
+        dump_mrg(out, &m);
+      }
+      fprintf(out, "} /* End of byte %d */\n", i);
     }
-    fprintf(out, "} /* End of byte %d */\n", i);
   }
   fprintf(out, "};\n");
   fclose(out);
 }
 
 /* Build this file with -DDUMP_TRANSITION_TABLE on the host system, then build
- * the output mrg_transitions.c */
+ * the output mrg_transitions.c.  With the argument "radix16", the output is
+ * mrg_transitions_radix16.c instead, needed by -DMRG_SKIP_RADIX16; the
+ * Makefile generates it in the build directory. */
 int main(int argc, char** argv) {
-  dump_mrg_powers();
+  dump_mrg_powers((argc > 1 && strcmp(argv[1], "radix16") == 0) ? 16 : 8);
   return 0;
 }
 #endif
 
+#ifdef CHECK_TRANSITION_TABLE
+/* Apply the matrix to st with the full 5x5 form of the matrix (see the top of
+ * this file) and plain % reductions, independently of mod_arith.h. */
+static void reference_apply_transition(const mrg_transition_matrix* mat, const mrg_state* st, mrg_state* r) {
+  const uint_fast64_t m = 0x7FFFFFFF, y = 104480;
+  const uint_fast64_t sy = mat->s * y % m, ay = mat->a * y % m, by = mat->b * y % m, cy = mat->c * y % m;
+  const uint_fast64_t rows[5][5] = {{mat->d, sy, ay, by, cy},
+                                    {mat->c, mat->w, sy, ay, by},
+                                    {mat->b, mat->v, mat->w, sy, ay},
+                                    {mat->a, mat->u, mat->v, mat->w, sy},
+                                    {mat->s, mat->t, mat->u, mat->v, mat->w}};
+  const uint_fast64_t z[5] = {st->z1, st->z2, st->z3, st->z4, st->z5};
+  uint_fast64_t out[5];
+  int i, j;
+  for (i = 0; i < 5; ++i) {
+    out[i] = 0;
+    for (j = 0; j < 5; ++j) out[i] = (out[i] + rows[i][j] * z[j] % m) % m;
+  }
+  r->z1 = out[0]; r->z2 = out[1]; r->z3 = out[2]; r->z4 = out[3]; r->z5 = out[4];
+}
+
+/* Validate the mod_arith backend against the precomputed table: build this
+ * file with -DCHECK_TRANSITION_TABLE (and the settings of user_settings.h to
+ * check) and run it, as `make check' does with the check_mrg_transitions
+ * programs.  Each matrix of mrg_skip_matrices is rebuilt with
+ * mrg_power and applied to a state with mrg_apply_transition, and to a few
+ * states with mrg_step_many, comparing the results with
+ * reference_apply_transition.  With -DMRG_SKIP_RADIX16, each matrix of
+ * mrg_skip_matrices_radix16 is also compared with the product of the two
+ * matrices of its bytes. */
+int main(int argc, char** argv) {
+  mrg_transition_matrix transition, m;
+  mrg_state state = {1, 2, 3, 4, 5}, expected, actual;
+  mrg_state many[11], many_expected[11]; /* not a multiple of the SIMD lanes */
+  int i, j, k, errors = 0;
+  for (k = 0; k < 11; ++k) {
+    mrg_state seed = {k + 1, 2 * k + 1, 3 * k + 1, 4 * k + 1, 0x7FFFFFFE - k};
+    many[k] = seed;
+  }
+  for (i = 0; i < 192 / 8; ++i) {
+    if (i == 0) {
+      mrg_make_A(&transition);
+    } else {
+      mrg_power(&transition, 256, &m);
+      transition = m;
+    }
+    for (j = 0; j < 256; ++j) {
+      const mrg_transition_matrix* table = &mrg_skip_matrices[i][j];
+      mrg_power(&transition, j, &m);
+      if (m.s != table->s || m.t != table->t || m.u != table->u || m.v != table->v || m.w != table->w ||
+          m.a != table->a || m.b != table->b || m.c != table->c || m.d != table->d) {
+        fprintf(stderr, "Mismatch in mrg_skip_matrices[%d][%d]\n", i, j);
+        ++errors;
+      }
+      reference_apply_transition(table, &state, &expected);
+      mrg_apply_transition(table, &state, &actual);
+      if (actual.z1 != expected.z1 || actual.z2 != expected.z2 || actual.z3 != expected.z3 || actual.z4 != expected.z4 || actual.z5 != expected.z5) {
+        fprintf(stderr, "Mismatch applying mrg_skip_matrices[%d][%d]\n", i, j);
+        ++errors;
+      }
+      if (j != 0) state = actual;
+      for (k = 0; k < 11; ++k) {
+        reference_apply_transition(table, &many[k], &many_expected[k]);
+      }
+      mrg_step_many(table, many, 11);
+      for (k = 0; k < 11; ++k) {
+        if (many[k].z1 != many_expected[k].z1 || many[k].z2 != many_expected[k].z2 || many[k].z3 != many_expected[k].z3 || many[k].z4 != many_expected[k].z4 || many[k].z5 != many_expected[k].z5) {
+          fprintf(stderr, "Mismatch applying mrg_skip_matrices[%d][%d] to many states\n", i, j);
+          ++errors;
+          break;
+        }
+      }
+    }
+  }
+#ifdef MRG_SKIP_RADIX16
+  for (i = 0; i < MRG_RADIX16_DIGITS; ++i) {
+    for (j = 0; j < 65536; ++j) {
+      const mrg_transition_matrix* table = &mrg_skip_matrices_radix16[i][j];
+      mrg_multiply(&mrg_skip_matrices[8 + 2 * i][j & 0xFF], &mrg_skip_matrices[9 + 2 * i][j >> 8], &m);
+      if (m.s != table->s || m.t != table->t || m.u != table->u || m.v != table->v || m.w != table->w ||
+          m.a != table->a || m.b != table->b || m.c != table->c || m.d != table->d) {
+        fprintf(stderr, "Mismatch in mrg_skip_matrices_radix16[%d][%d]\n", i, j);
+        ++errors;
+      }
+    }
+  }
+#endif
+  printf("%d mismatches\n", errors);
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
+
 /* Returns integer value in [0, 2^31-1) using original transition matrix. */
 uint_fast32_t mrg_get_uint_orig(mrg_state* state) {
   mrg_orig_step(state);
@@ -10,7 +10,9 @@
 #ifndef SPLITTABLE_MRG_H
 #define SPLITTABLE_MRG_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include "kernel_isa.h"
 
 /* Multiple recursive generator from L'Ecuyer, P., Blouin, F., and       */
 /* Couture, R. 1993. A search for good multiple recursive random number  */
@@ -48,6 +50,13 @@ void mrg_skip(mrg_state* state,
               uint_least64_t exponent_middle,
               uint_least64_t exponent_low);
 
+/* mrg_skip on each of the states [0, n), with the same exponent.  The states
+ * are advanced together, several at a time with SIMD instructions. */
+void mrg_skip_many(mrg_state* states, size_t n,
+                   uint_least64_t exponent_high,
+                   uint_least64_t exponent_middle,
+                   uint_least64_t exponent_low);
+
 #ifdef __cplusplus
 }
 #endif
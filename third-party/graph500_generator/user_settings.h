@@ -18,6 +18,16 @@
 #define FAST_64BIT_ARITHMETIC /* Use 64-bit arithmetic when possible. */
 /* #undef FAST_64BIT_ARITHMETIC -- Assume 64-bit arithmetic is slower than 32-bit. */
 
+#define MERSENNE_MOD_ARITH /* With 64-bit arithmetic, reduce modulo 2^31-1 with shifts and adds (mod_arith_mersenne.h). */
+/* #undef MERSENNE_MOD_ARITH -- Reduce with the % operator (mod_arith_64bit.h). */
+
+#define MRG_PACKED_SKIP_TABLE /* Store the MRG skip matrices in 32-bit fields, 64-byte aligned. */
+/* #undef MRG_PACKED_SKIP_TABLE -- Store them in uint_fast32_t fields. */
+
+/* Build with -DMRG_SKIP_RADIX16 to also skip the low 32 bits of
+ * exponent_middle with 16-bit digits (mrg_transitions_radix16.c, generated
+ * at build time by dump_mrg_powers). */
+
 /* End of user settings ----------------------------------- */
 
 #endif /* USER_SETTINGS_H */
@@ -0,0 +1,131 @@
+/* Use, modification and distribution is subject to the Boost Software     */
+/* License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at */
+/* http://www.boost.org/LICENSE_1_0.txt)                                   */
+
+#ifndef WEIGHT_POLICY_H
+#define WEIGHT_POLICY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+/* The weights of the edges: the distribution of their values and the type
+ * they are stored as, shared by graph_generator.c and the generators outside
+ * it.  Whatever the policy, an edge draws a single random value for its
+ * weight, after those of its endpoints, so the edges do not depend on it.
+ * The default policy, floats uniform in [0, 1), gives the weights of the
+ * specification. */
+
+typedef enum weight_type {
+  WEIGHT_FLOAT = 0, /* float */
+  WEIGHT_INT32,     /* int32_t */
+  WEIGHT_UINT16,    /* uint16_t */
+  WEIGHT_UINT8      /* uint8_t */
+} weight_type;
+
+typedef enum weight_distribution {
+  WEIGHT_UNIFORM = 0, /* floats in [min, max), or the integers in [min, max] */
+  WEIGHT_EXPONENTIAL, /* of the given mean */
+  WEIGHT_LOG_NORMAL,  /* exp(X), X normal of mean mu and deviation sigma */
+  WEIGHT_LEGACY_INT32 /* int32 only, the former --int32: (int32_t)(u * INT32_MAX)
+                         / 1024, from the float u of the default policy */
+} weight_distribution;
+
+/* The integer types store the exponential and log-normal values rounded to the
+ * nearest integer, saturated to the range of the type. */
+typedef struct weight_policy {
+  weight_distribution distribution;
+  weight_type type;
+  double min, max;  /* uniform */
+  double mean;      /* exponential */
+  double mu, sigma; /* log-normal */
+} weight_policy;
+
+#define WEIGHT_POLICY_DEFAULT { WEIGHT_UNIFORM, WEIGHT_FLOAT, 0, 1, 1, 0, 1 }
+
+/* Bytes per weight */
+static inline size_t weight_size(weight_type type) {
+  switch (type) {
+    case WEIGHT_INT32: return sizeof(int32_t);
+    case WEIGHT_UINT16: return sizeof(uint16_t);
+    case WEIGHT_UINT8: return sizeof(uint8_t);
+    default: return sizeof(float);
+  }
+}
+
+/* The element i of weights, an array of the given type, or NULL for the
+ * unweighted graphs (weights == NULL). */
+static inline void* weight_at(void* weights, int64_t i, weight_type type) {
+  return (weights != NULL) ? (char*)weights + i * (int64_t)weight_size(type) : NULL;
+}
+
+/* The quantile function of the standard normal distribution, for p in (0, 1),
+ * with the rational approximations of P. J. Acklam (relative error < 1.2e-9). */
+static inline double weight_normal_quantile(double p) {
+  static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                              1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+  static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                              6.680131188771972e+01, -1.328068155288572e+01};
+  static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                              -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+  static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                              3.754408661907416e+00};
+  const double p_low = 0.02425;
+  double q, r;
+  if (p < p_low || p > 1 - p_low) { /* tails */
+    q = sqrt(-2 * log((p < p_low) ? p : 1 - p));
+    r = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+        ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    return (p < p_low) ? r : -r;
+  } else {
+    q = p - 0.5;
+    r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+  }
+}
+
+/* Store into weights[i], an array of the type of the policy, the weight drawn
+ * from the random value raw in [0, range).  u is the same draw as a float in
+ * [0, 1), as the generator computes it: uniform floats are derived from u, for
+ * the default policy to store it unchanged. */
+static inline void store_weight(void* weights, int64_t i, const weight_policy* policy, uint32_t raw, uint32_t range, float u) {
+  double x;
+  if (policy->distribution == WEIGHT_LEGACY_INT32) {
+    ((int32_t*)weights)[i] = (int32_t)((double)u * INT32_MAX) / 1024;
+    return;
+  }
+  if (policy->distribution == WEIGHT_UNIFORM) {
+    if (policy->type == WEIGHT_FLOAT) {
+      ((float*)weights)[i] = (float)(policy->min + (policy->max - policy->min) * u);
+      return;
+    }
+    /* min + floor(raw * span / range), span <= 2^32 and raw < 2^31 */
+    x = policy->min + (double)((uint64_t)raw * (uint64_t)(policy->max - policy->min + 1) / range);
+  } else {
+    double p = ((double)raw + 0.5) / range; /* in (0, 1) */
+    if (policy->distribution == WEIGHT_EXPONENTIAL) {
+      x = -policy->mean * log(p);
+    } else {
+      x = exp(policy->mu + policy->sigma * weight_normal_quantile(p));
+    }
+    if (policy->type != WEIGHT_FLOAT) x = floor(x + 0.5);
+  }
+
+  switch (policy->type) {
+    case WEIGHT_INT32:
+      ((int32_t*)weights)[i] = (int32_t)((x < INT32_MIN) ? INT32_MIN : (x > INT32_MAX) ? INT32_MAX : x);
+      break;
+    case WEIGHT_UINT16:
+      ((uint16_t*)weights)[i] = (uint16_t)((x < 0) ? 0 : (x > UINT16_MAX) ? UINT16_MAX : x);
+      break;
+    case WEIGHT_UINT8:
+      ((uint8_t*)weights)[i] = (uint8_t)((x < 0) ? 0 : (x > UINT8_MAX) ? UINT8_MAX : x);
+      break;
+    default:
+      ((float*)weights)[i] = (float)x;
+      break;
+  }
+}
+
+#endif /* WEIGHT_POLICY_H */
@@ -0,0 +1,57 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "kronecker.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "third-party/graph500_generator/scramble.h"
+#include "third-party/graph500_generator/utils.h" // make_mrg_seed
+
+using namespace std;
+
+VertexScrambler::VertexScrambler(const KroneckerParameters& params) : m_val0(0), m_val1(0), m_enabled(params.scramble) {
+    const uint64_t order = params.initiator_matrix.empty() ? 2 : static_cast<uint64_t>(sqrt(static_cast<double>(params.initiator_matrix.size())) + 0.5);
+    if(params.scale <= 0 || params.scale > 62 || order < 2 || order * order != (params.initiator_matrix.empty() ? 4 : params.initiator_matrix.size())) { throw std::invalid_argument("[VertexScrambler] invalid scale or initiator"); }
+    uint64_t max_vertices = 1; // k^scale
+    for(int level = 0; level < params.scale; level++){
+        if(max_vertices > (UINT64_C(1) << 62) / order) { throw std::invalid_argument("[VertexScrambler] the k^scale vertices do not fit in the vertex ids"); }
+        max_vertices *= order;
+    }
+    m_num_vertices = (params.num_vertices == 0) ? max_vertices : params.num_vertices;
+    if(m_num_vertices < 2 || m_num_vertices > max_vertices) { throw std::invalid_argument("[VertexScrambler] the number of vertices must be in [2, k^scale]"); }
+    m_num_bits = 64 - __builtin_clzll(m_num_vertices -1);
+
+    uint_fast32_t seed[5];
+    make_mrg_seed(params.userseed1, params.userseed2, seed);
+    make_scramble_values(seed, &m_val0, &m_val1);
+}
+
+int64_t VertexScrambler::scramble(int64_t vertex) const {
+    if(!m_enabled) return vertex;
+    do { // cycle walking, for the number of vertices that are not a power of two
+        vertex = ::scramble(vertex, m_num_bits, m_val0, m_val1);
+    } while(static_cast<uint64_t>(vertex) >= m_num_vertices);
+    return vertex;
+}
+
+int64_t VertexScrambler::inverse(int64_t id) const {
+    if(!m_enabled) return id;
+    do {
+        id = inverse_scramble(id, m_num_bits, m_val0, m_val1);
+    } while(static_cast<uint64_t>(id) >= m_num_vertices);
+    return id;
+}